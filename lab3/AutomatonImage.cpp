@@ -0,0 +1,232 @@
+#include "AutomatonImage.hpp"
+#include "PushDownAutomaton.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+AutomatonImage::AutomatonImage () {
+  data_ = NULL;
+  size_ = 0;
+  header_ = NULL;
+}
+
+AutomatonImage::~AutomatonImage () {
+  close();
+}
+
+bool AutomatonImage::isImage (string fileName) {
+  ifstream file (fileName.c_str(), ios::binary);
+  char magic[sizeof(IMAGE_MAGIC)];
+  return file.read(magic, sizeof(magic)) && memcmp(magic, IMAGE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool AutomatonImage::write (const PushDownAutomaton& automaton, string fileName) {
+  const vector<transition_t>& transitions = automaton.getTransitions();
+  const TransitionTable& table = automaton.getTransitionTable();
+  vector<unsigned> sections[IMAGE_SECTIONS];
+  string pool;
+
+  // Strings are kept as offsets in the pool, one extra offset closes the last one.
+  auto addStrings = [&] (image_section_t section, const vector<string>& strings) {
+    for (unsigned i = 0; i < strings.size(); i++) {
+      sections[section].push_back(pool.size());
+      pool += strings[i];
+    }
+    sections[section].push_back(pool.size());
+  };
+  auto addNames = [&] (image_section_t section, const SymbolTable& symbols) {
+    vector<string> names;
+    for (symbol_t id = 0; id < symbols.size(); id++)
+      names.push_back(symbols.name(id));
+    addStrings(section, names);
+  };
+
+  addStrings(DEFINITION_SECTION, automaton.getDefinition());
+  addNames(STATE_NAMES_SECTION, automaton.getStates());
+  addNames(INPUT_NAMES_SECTION, automaton.getInputSymbols());
+  addNames(STACK_NAMES_SECTION, automaton.getStackSymbols());
+
+  vector<string> text;
+  vector<symbol_t> push;
+  symbol_t state;
+  sections[PUSH_START_SECTION].push_back(0);
+  for (unsigned i = 0; i < transitions.size(); i++) {
+    text.push_back(transitions[i].actual);
+    text.push_back(transitions[i].next);
+    sections[KEYS_SECTION].push_back(transitions[i].state);
+    sections[KEYS_SECTION].push_back(transitions[i].input);
+    sections[KEYS_SECTION].push_back(transitions[i].top);
+
+    automaton.readTarget(i, state, push);
+    sections[TARGET_STATES_SECTION].push_back(state);
+    sections[PUSH_SYMBOLS_SECTION].insert(sections[PUSH_SYMBOLS_SECTION].end(), push.begin(), push.end());
+    sections[PUSH_START_SECTION].push_back(sections[PUSH_SYMBOLS_SECTION].size());
+  }
+  addStrings(TEXT_SECTION, text);
+  const unsigned* slots = (const unsigned*) table.getSlots();
+  sections[CELL_SLOTS_SECTION].assign(slots, slots + table.getSlotCount() * (sizeof(cell_slot_t) / sizeof(unsigned)));
+  sections[CELL_ENTRIES_SECTION].assign(table.getEntries(), table.getEntries() + table.getEntryCount());
+  automaton.getEpsilonAnalysis().store(sections[ANALYSIS_FLAGS_SECTION], sections[ANALYSIS_STARTS_SECTION],
+                                       sections[WEIGHTS_SECTION]);
+
+  image_header_t header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+  header.version = IMAGE_VERSION;
+  header.byteOrder = IMAGE_BYTE_ORDER;
+  header.states = automaton.getStates().size();
+  header.inputs = automaton.getInputSymbols().size();
+  header.stackSymbols = automaton.getStackSymbols().size();
+  header.stackAlphabetSize = automaton.getStackAlphabetSize();
+  header.transitions = transitions.size();
+  header.cellSlots = table.getSlotCount();
+  header.deterministic = automaton.isDeterministic();
+  header.analysisComplete = automaton.getEpsilonAnalysis().isComplete();
+
+  // Sections follow the header, every one aligned to 8 bytes.
+  unsigned long long offset = sizeof(header);
+  for (unsigned s = 0; s < IMAGE_SECTIONS; s++) {
+    offset = (offset + 7) & ~7ull;
+    header.offset[s] = offset;
+    header.size[s] = s == STRING_POOL_SECTION ? pool.size() : sections[s].size() * sizeof(unsigned);
+    offset += header.size[s];
+  }
+
+  ofstream file (fileName.c_str(), ios::binary | ios::trunc);
+  if (!file.is_open())
+    return false;
+  file.write((const char*) &header, sizeof(header));
+  const char padding[8] = { 0 };
+  for (unsigned s = 0; s < IMAGE_SECTIONS; s++) {
+    file.write(padding, header.offset[s] - file.tellp());
+    if (s == STRING_POOL_SECTION)
+      file.write(pool.data(), pool.size());
+    else
+      file.write((const char*) sections[s].data(), header.size[s]);
+  }
+  return file.good();
+}
+
+bool AutomatonImage::open (string fileName) {
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (unsigned long long) info.st_size < sizeof(image_header_t)) {
+    ::close(fd);
+    return false;
+  }
+  // Shared and read only: every process that maps the image uses the same cached pages.
+  void* data = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  data_ = (const char*) data;
+  size_ = info.st_size;
+  header_ = (const image_header_t*) data_;
+  if (!check()) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+void AutomatonImage::close () {
+  if (data_ != NULL)
+    munmap((void*) data_, size_);
+  data_ = NULL;
+  size_ = 0;
+  header_ = NULL;
+}
+
+string AutomatonImage::getString (image_section_t section, unsigned i) const {
+  const unsigned* offsets = getSection(section);
+  return string(data_ + header_->offset[STRING_POOL_SECTION] + offsets[i], offsets[i + 1] - offsets[i]);
+}
+
+// Every id and offset of the image is checked once, so the engines can index its arrays without checks.
+bool AutomatonImage::check () const {
+  const image_header_t& h = *header_;
+  if (memcmp(h.magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 || h.version != IMAGE_VERSION ||
+      h.byteOrder != IMAGE_BYTE_ORDER)
+    return false;
+  for (unsigned s = 0; s < IMAGE_SECTIONS; s++)
+    if (h.offset[s] % sizeof(unsigned) != 0 || h.offset[s] > size_ || h.size[s] > size_ - h.offset[s])
+      return false;
+
+  unsigned long long pool = h.size[STRING_POOL_SECTION];
+  if (h.stackAlphabetSize > h.stackSymbols || h.inputs == 0 || h.cellSlots == 0 || (h.cellSlots & (h.cellSlots - 1)) != 0)
+    return false;
+  if (!checkSection(DEFINITION_SECTION, DEFINITION_LINES + 1) || !checkSection(STATE_NAMES_SECTION, h.states + 1ull) ||
+      !checkSection(INPUT_NAMES_SECTION, h.inputs + 1ull) || !checkSection(STACK_NAMES_SECTION, h.stackSymbols + 1ull) ||
+      !checkSection(TEXT_SECTION, 2ull * h.transitions + 1) || !checkSection(KEYS_SECTION, 3ull * h.transitions) ||
+      !checkSection(CELL_SLOTS_SECTION, (unsigned long long) h.cellSlots * (sizeof(cell_slot_t) / sizeof(unsigned))) ||
+      !checkSection(CELL_ENTRIES_SECTION, h.transitions) ||
+      !checkSection(TARGET_STATES_SECTION, h.transitions) || !checkSection(PUSH_START_SECTION, h.transitions + 1ull) ||
+      !checkSection(ANALYSIS_FLAGS_SECTION, h.transitions) || !checkSection(WEIGHTS_SECTION, h.stackSymbols) ||
+      !checkSection(ANALYSIS_STARTS_SECTION, h.analysisComplete ? EpsilonAnalysis::getStartsSize(h.transitions, h.inputs) : 0))
+    return false;
+  if (!checkAscending(DEFINITION_SECTION, pool) || !checkAscending(STATE_NAMES_SECTION, pool) ||
+      !checkAscending(INPUT_NAMES_SECTION, pool) || !checkAscending(STACK_NAMES_SECTION, pool) ||
+      !checkAscending(TEXT_SECTION, pool) || !checkAscending(PUSH_START_SECTION, ~0u) || !checkSlots())
+    return false;
+
+  const unsigned* pushStart = getSection(PUSH_START_SECTION);
+  if (pushStart[0] != 0 ||
+      !checkSection(PUSH_SYMBOLS_SECTION, pushStart[h.transitions]))
+    return false;
+
+  const unsigned* keys = getSection(KEYS_SECTION);
+  for (unsigned i = 0; i < h.transitions; i++)
+    if (keys[3 * i] >= h.states || keys[3 * i + 1] >= h.inputs || keys[3 * i + 2] >= h.stackSymbols)
+      return false;
+  return checkIds(CELL_ENTRIES_SECTION, h.transitions) && checkIds(TARGET_STATES_SECTION, h.states) &&
+         checkIds(PUSH_SYMBOLS_SECTION, h.stackSymbols);
+}
+
+// The ids and ranges of the cells are in bounds, and one slot at least is empty so every lookup ends.
+bool AutomatonImage::checkSlots () const {
+  const image_header_t& h = *header_;
+  const cell_slot_t* slots = (const cell_slot_t*) getSection(CELL_SLOTS_SECTION);
+  bool empty = false;
+  for (unsigned i = 0; i < h.cellSlots; i++) {
+    if (slots[i].begin > slots[i].end || slots[i].end > h.transitions)
+      return false;
+    if (slots[i].state == NO_SYMBOL) {
+      if (slots[i].begin != slots[i].end)
+        return false;
+      empty = true;
+      continue;
+    }
+    if (slots[i].state >= h.states || slots[i].input >= h.inputs || slots[i].top >= h.stackSymbols)
+      return false;
+  }
+  return empty;
+}
+
+bool AutomatonImage::checkSection (image_section_t section, unsigned long long entries) const {
+  return header_->size[section] == entries * sizeof(unsigned);
+}
+
+bool AutomatonImage::checkIds (image_section_t section, unsigned limit) const {
+  const unsigned* values = getSection(section);
+  unsigned long long n = header_->size[section] / sizeof(unsigned);
+  for (unsigned long long i = 0; i < n; i++)
+    if (values[i] >= limit)
+      return false;
+  return true;
+}
+
+bool AutomatonImage::checkAscending (image_section_t section, unsigned long long last) const {
+  const unsigned* values = getSection(section);
+  unsigned long long n = header_->size[section] / sizeof(unsigned);
+  for (unsigned long long i = 1; i < n; i++)
+    if (values[i] < values[i - 1])
+      return false;
+  return n == 0 || values[n - 1] <= last;
+}
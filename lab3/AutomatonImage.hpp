@@ -0,0 +1,86 @@
+/***
+* @description: Compiled binary image of an automaton: the interned symbol tables, the indexed transition
+*               table, the targets of every transition and the analysis of its e-transitions. The image
+*               is mapped read only and its arrays are used in place, so loading it parses nothing and
+*               processes share its pages.
+***/
+#ifndef _AUTOMATON_IMAGE_HPP_
+#define _AUTOMATON_IMAGE_HPP_
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+const char IMAGE_MAGIC[8] = { 'P', 'D', 'A', 'I', 'M', 'A', 'G', 'E' };
+const unsigned IMAGE_VERSION = 3;
+const unsigned IMAGE_BYTE_ORDER = 0x01020304;   // Read back in another order on machines that can't use the image.
+
+// Sections of the image, every one is an array of unsigned.
+enum image_section_t {
+  DEFINITION_SECTION,    // Offsets in the string pool of the six definition lines of the automaton file.
+  STATE_NAMES_SECTION,   // Offsets in the string pool of the names of every id.
+  INPUT_NAMES_SECTION,
+  STACK_NAMES_SECTION,
+  TEXT_SECTION,          // Offsets in the string pool of the text of every transition, actual then next.
+  KEYS_SECTION,          // State, input and top of every transition.
+  CELL_SLOTS_SECTION,    // Transition table, same layout as TransitionTable: five unsigned by slot.
+  CELL_ENTRIES_SECTION,
+  TARGET_STATES_SECTION, // Next state of every transition.
+  PUSH_START_SECTION,    // Where the symbols to push of every transition begin (one extra at the end).
+  PUSH_SYMBOLS_SECTION,  // Symbols to push, in push order.
+  ANALYSIS_FLAGS_SECTION,   // EpsilonAnalysis::store of every transition: dead, growing, transparent.
+  ANALYSIS_STARTS_SECTION,  // Input symbols every transition reads first, empty if the analysis is not complete.
+  WEIGHTS_SECTION,          // Input needed to pop every stack symbol.
+  STRING_POOL_SECTION,   // Characters of every string, one after the other.
+  IMAGE_SECTIONS
+};
+
+const unsigned DEFINITION_LINES = 6;
+
+struct image_header_t {
+  char magic[8];
+  unsigned version;
+  unsigned byteOrder;
+  unsigned states;
+  unsigned inputs;
+  unsigned stackSymbols;
+  unsigned stackAlphabetSize;
+  unsigned transitions;
+  unsigned cellSlots;
+  unsigned deterministic;
+  unsigned analysisComplete;
+  unsigned long long offset[IMAGE_SECTIONS];   // Bytes from the beginning of the image.
+  unsigned long long size[IMAGE_SECTIONS];     // Bytes of the section.
+};
+
+class AutomatonImage {
+  const char* data_;   // Whole mapped file, NULL when nothing is mapped.
+  unsigned long long size_;
+  const image_header_t* header_;
+
+public:
+  AutomatonImage ();
+  ~AutomatonImage ();
+
+  static bool isImage (string fileName);   // The file starts with the magic of an image.
+  static bool write (const PushDownAutomaton& automaton, string fileName);
+
+  bool open (string fileName);   // Map the image and check it can be used safely.
+  void close ();
+
+  const image_header_t& getHeader () const { return *header_; };
+  const unsigned* getSection (image_section_t section) const { return (const unsigned*) (data_ + header_->offset[section]); };
+  string getString (image_section_t section, unsigned i) const;   // i-th string of a section of offsets.
+
+private:
+  bool check () const;
+  bool checkSection (image_section_t section, unsigned long long entries) const;
+  bool checkIds (image_section_t section, unsigned limit) const;
+  bool checkAscending (image_section_t section, unsigned long long last) const;
+  bool checkSlots () const;
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "BatchChecker.hpp"
+#include "PushDownAutomaton.hpp"
+#include <chrono>
+#include <thread>
+
+const unsigned long WORDS_PER_TAKE = 64;   // Words a thread takes from the shared counter at once.
+
+
+BatchChecker::BatchChecker (const PushDownAutomaton& automaton, unsigned threads) : automaton_(automaton) {
+  threads_ = max(threads, 1u);
+  start_.push_back(0);
+  seconds_ = 0;
+  shared_ = automaton_.getRunConfig().isIncremental() && automaton_.getEngine() == SEARCH_ENGINE && !automaton_.hasParser();
+}
+
+BatchChecker::~BatchChecker () {}
+
+bool BatchChecker::loadWords (string fileName) {
+  ifstream file (fileName.c_str());
+  if (!file.is_open()) {
+    cerr << "El fichero no existe" << endl;
+    return false;
+  }
+
+  // Lines are split like the input files; "e" and unknown symbols can't be read by any transition.
+  const SymbolTable& inputs = automaton_.getInputSymbols();
+  Tokenizer tokenizer (inputs, inputs.size());
+  vector<string_view> tokens;
+  string line;
+  while (getline(file, line)) {
+    tokenizer.split(line, tokens);
+    for (unsigned i = 0; i < tokens.size(); i++) {
+      symbol_t symbol = inputs.find(string(tokens[i]));
+      symbols_.push_back(symbol == EPSILON ? NO_SYMBOL : symbol);
+    }
+    start_.push_back(symbols_.size());
+  }
+  return true;
+}
+
+void BatchChecker::run () {
+  results_.assign(getWordCount(), makeResult(false, NO_BUDGET, false));
+  latencies_.assign(getWordCount(), 0);
+  resumed_.assign(getWordCount(), 0);
+  order_.resize(getWordCount());
+  for (unsigned long i = 0; i < order_.size(); i++)
+    order_[i] = i;
+
+  atomic<unsigned long> next (0);
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  if (shared_)
+    sortWords();
+  vector<thread> pool;
+  for (unsigned i = 1; i < threads_; i++)
+    pool.push_back(thread(&BatchChecker::work, this, &next));
+  work(&next);
+  for (unsigned i = 0; i < pool.size(); i++)
+    pool[i].join();
+  seconds_ = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
+
+// Words with a common prefix end up next to each other, and the ones in between share it too.
+void BatchChecker::sortWords () {
+  sort(order_.begin(), order_.end(), [this] (unsigned long a, unsigned long b) {
+    return lexicographical_compare(symbols_.begin() + start_[a], symbols_.begin() + start_[a + 1],
+                                   symbols_.begin() + start_[b], symbols_.begin() + start_[b + 1]);
+  });
+}
+
+// Take words from the shared counter until there are none left. Every thread keeps its own incremental
+// checker, the words it takes at once are next to each other in the sorted order.
+void BatchChecker::work (atomic<unsigned long>* next) {
+  vector<symbol_t> tape;
+  unsigned long words = getWordCount();
+  IncrementalChecker* checker = NULL;
+  if (shared_) {
+    checker = new IncrementalChecker(automaton_, automaton_.getRunConfig());
+    unsigned longest = 0;
+    for (unsigned long i = 0; i < words; i++)
+      longest = max(longest, (unsigned) (start_[i + 1] - start_[i]));
+    checker->reserve(longest);
+  }
+  while (true) {
+    unsigned long first = next->fetch_add(WORDS_PER_TAKE);
+    if (first >= words) {
+      delete checker;
+      return;
+    }
+    unsigned long last = min(first + WORDS_PER_TAKE, words);
+    for (unsigned long j = first; j < last; j++) {
+      unsigned long i = order_[j];
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      tape.assign(symbols_.begin() + start_[i], symbols_.begin() + start_[i + 1]);
+      // An empty word is never accepted, like an empty input tape.
+      if (!tape.empty() && checker != NULL) {
+        results_[i] = checker->update(tape);
+        resumed_[i] = checker->getResumed();
+      }
+      else if (!tape.empty())
+        results_[i] = automaton_.checkTape(tape);
+      latencies_[i] = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    }
+  }
+}
+
+void BatchChecker::showVerdicts (ostream& out) const {
+  for (unsigned long i = 0; i < results_.size(); i++) {
+    if (results_[i].verdict == INPUT_ACCEPTED)
+      out << "accepted" << '\n';
+    else if (results_[i].verdict == INPUT_REJECTED)
+      out << "rejected" << '\n';
+    else
+      out << "exhausted " << RunConfig::getBudgetName(results_[i].budget) << '\n';
+  }
+  out.flush();
+}
+
+void BatchChecker::showSummary (ostream& out) const {
+  unsigned long words = getWordCount();
+  unsigned long accepted = 0;
+  unsigned long exhausted = 0;
+  for (unsigned long i = 0; i < words; i++) {
+    accepted += results_[i].verdict == INPUT_ACCEPTED;
+    exhausted += results_[i].verdict == BUDGET_EXHAUSTED;
+  }
+
+  out << "Checked " << words << " inputs (" << accepted << " accepted, " << exhausted << " out of budget) in " << seconds_ << " s with "
+      << threads_ << " threads: " << (seconds_ > 0 ? words / seconds_ : 0) << " inputs/s" << endl;
+  if (shared_) {
+    unsigned long resumed = 0;
+    for (unsigned long i = 0; i < words; i++)
+      resumed += resumed_[i];
+    out << "Shared prefixes: " << resumed << " of " << symbols_.size() << " symbols were not checked again" << endl;
+  }
+  if (words == 0)
+    return;
+
+  vector<double> sorted (latencies_);
+  sort(sorted.begin(), sorted.end());
+  double percentiles[] = { 50, 90, 99, 99.9 };
+  out << "Latency (us):";
+  for (unsigned i = 0; i < 4; i++)
+    out << " p" << percentiles[i] << " " << sorted[(unsigned long) ((words - 1) * percentiles[i] / 100)];
+  out << " max " << sorted.back() << endl;
+}
@@ -0,0 +1,49 @@
+/***
+* @description: Checks many inputs against one loaded automaton. The inputs are read from a file with one
+*               word per line (split into symbols like an input file) and checked by a pool of threads.
+*               Verdicts are written in the order of the file: accepted, rejected or the budget that ran
+*               out. In incremental mode the words are checked in sorted order, which walks the trie of
+*               the words depth-first: every word goes on from the configurations of the prefix it shares
+*               with the word before, so a shared prefix is checked once.
+***/
+#ifndef _BATCH_CHECKER_HPP_
+#define _BATCH_CHECKER_HPP_
+#include <iostream>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+#include "RunConfig.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+class BatchChecker {
+  const PushDownAutomaton& automaton_;
+  unsigned threads_;
+  vector<symbol_t> symbols_;     // Symbols of every word, one after the other.
+  vector<unsigned long> start_;  // Where every word begins in symbols_ (one extra at the end).
+  vector<check_result_t> results_;
+  vector<double> latencies_;     // Microseconds spent on every word.
+  bool shared_;                  // Words share the configurations of their common prefixes.
+  vector<unsigned long> order_;  // Words in the order they are checked.
+  vector<unsigned> resumed_;     // Symbols of every word that were not checked again.
+  double seconds_;
+
+public:
+  BatchChecker (const PushDownAutomaton& automaton, unsigned threads);
+  ~BatchChecker ();
+
+  bool loadWords (string fileName);
+  void run ();
+  void showVerdicts (ostream& out) const;
+  void showSummary (ostream& out) const;
+  unsigned long getWordCount () const { return start_.size() - 1; };
+
+private:
+  void work (atomic<unsigned long>* next);
+  void sortWords ();
+};
+
+#endif
@@ -0,0 +1,30 @@
+/***
+* @description: Configuration of the pushdown automaton kept in the frontier of the search. The tape
+*               and the stacks are shared, so it only keeps the read position and the stack reference.
+***/
+#ifndef _CONFIGURATION_HPP_
+#define _CONFIGURATION_HPP_
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+
+using namespace std;
+
+const unsigned NO_PARENT = ~0u;       // Parent of the initial configuration.
+const unsigned NO_TRANSITION = ~0u;   // Returned when a configuration has no transitions left.
+
+struct configuration_t {
+  symbol_t state;
+  unsigned pos;           // Read position on the tape.
+  stack_ref stack;
+  unsigned parent;        // Configuration it was reached from.
+  unsigned transition;    // Transition taken from the parent, the derivation is rebuilt from them.
+  unsigned stackMark;     // Stack nodes created from here on belong to this configuration.
+
+  // Transitions still to try: the ones reading the symbol and the e-transitions, merged in file order.
+  const unsigned* read;
+  const unsigned* readEnd;
+  const unsigned* empty;
+  const unsigned* emptyEnd;
+};
+
+#endif
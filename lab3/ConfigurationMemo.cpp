@@ -0,0 +1,74 @@
+#include "ConfigurationMemo.hpp"
+
+const unsigned INITIAL_SLOTS = 1024;
+
+
+// Fingerprints are never 0 so the empty slots can be told apart.
+static fingerprint_t key (fingerprint_t fingerprint) {
+  return fingerprint ? fingerprint : 1;
+}
+
+static unsigned long long hashKey (symbol_t state, unsigned pos, fingerprint_t fingerprint) {
+  unsigned long long h = fingerprint ^ (state * 0x9E3779B97F4A7C15ULL) ^ (pos * 0xC2B2AE3D27D4EB4FULL);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  return h ^ (h >> 33);
+}
+
+ConfigurationMemo::ConfigurationMemo () {
+  clear();
+}
+
+ConfigurationMemo::~ConfigurationMemo () {}
+
+// Slot of the configuration, or the empty slot where it has to be inserted.
+unsigned ConfigurationMemo::findSlot (symbol_t state, unsigned pos, fingerprint_t fingerprint) const {
+  unsigned mask = slots_.size() - 1;
+  unsigned i = hashKey(state, pos, fingerprint) & mask;
+  while (slots_[i].fingerprint != 0 &&
+         (slots_[i].fingerprint != fingerprint || slots_[i].state != state || slots_[i].pos != pos))
+    i = (i + 1) & mask;
+  return i;
+}
+
+bool ConfigurationMemo::insert (symbol_t state, unsigned pos, fingerprint_t fingerprint) {
+  fingerprint = key(fingerprint);
+  unsigned i = findSlot(state, pos, fingerprint);
+  if (slots_[i].fingerprint != 0)
+    return false;
+
+  slots_[i].fingerprint = fingerprint;
+  slots_[i].state = state;
+  slots_[i].pos = pos;
+  if (++count_ * 2 > slots_.size())
+    grow();
+  return true;
+}
+
+bool ConfigurationMemo::contains (symbol_t state, unsigned pos, fingerprint_t fingerprint) const {
+  fingerprint = key(fingerprint);
+  return slots_[findSlot(state, pos, fingerprint)].fingerprint != 0;
+}
+
+void ConfigurationMemo::clear () {
+  slot_t empty;
+  empty.fingerprint = 0;
+  empty.state = NO_SYMBOL;
+  empty.pos = 0;
+  slots_.assign(INITIAL_SLOTS, empty);
+  count_ = 0;
+}
+
+// Keep the load under one half so probing sequences stay short.
+void ConfigurationMemo::grow () {
+  vector<slot_t> old;
+  old.swap(slots_);
+  slot_t empty;
+  empty.fingerprint = 0;
+  empty.state = NO_SYMBOL;
+  empty.pos = 0;
+  slots_.assign(old.size() * 2, empty);
+  for (unsigned i = 0; i < old.size(); i++)
+    if (old[i].fingerprint != 0)
+      slots_[findSlot(old[i].state, old[i].pos, old[i].fingerprint)] = old[i];
+}
@@ -0,0 +1,39 @@
+/***
+* @description: Set of the configurations already visited by the search, keyed on the state, the
+*               position on the tape and the fingerprint of the stack. Open addressing with linear probing.
+***/
+#ifndef _CONFIGURATION_MEMO_HPP_
+#define _CONFIGURATION_MEMO_HPP_
+#include <vector>
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+
+using namespace std;
+
+class ConfigurationMemo {
+  struct slot_t {
+    fingerprint_t fingerprint;   // 0 marks an empty slot.
+    symbol_t state;
+    unsigned pos;
+  };
+
+  vector<slot_t> slots_;   // Size is always a power of two.
+  unsigned count_;
+
+public:
+  ConfigurationMemo ();
+  ~ConfigurationMemo ();
+
+  bool insert (symbol_t state, unsigned pos, fingerprint_t fingerprint);   // False if it was already there.
+  bool contains (symbol_t state, unsigned pos, fingerprint_t fingerprint) const;
+  void clear ();
+  unsigned getSize () const { return count_; };
+  unsigned long getMemory () const { return slots_.size() * sizeof(slot_t); };
+  static unsigned long getEntryMemory () { return 4 * sizeof(slot_t); };   // Bytes per entry right after growing.
+
+private:
+  unsigned findSlot (symbol_t state, unsigned pos, fingerprint_t fingerprint) const;
+  void grow ();
+};
+
+#endif
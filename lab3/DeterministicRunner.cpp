@@ -0,0 +1,155 @@
+#include "DeterministicRunner.hpp"
+#include "PushDownAutomaton.hpp"
+
+
+DeterministicRunner::DeterministicRunner (const PushDownAutomaton& automaton, const RunConfig& config)
+  : automaton_(automaton), config_(config) {
+  statistics_ = NULL;
+  moves_ = 0;
+  maxDepth_ = 0;
+  stopped_ = NO_BUDGET;
+  accepted_ = false;
+}
+
+DeterministicRunner::~DeterministicRunner () {}
+
+// The only transition of the configuration, or NO_TRANSITION. Like in the search, a transition after
+// which the input can't be read anymore is not taken.
+unsigned DeterministicRunner::findTransition (symbol_t state, symbol_t symbol, symbol_t top) const {
+  const TransitionTable& table = automaton_.getTransitionTable();
+  const unsigned* begin;
+  const unsigned* end;
+  unsigned transition = NO_TRANSITION;
+  table.getRange(state, symbol, top, begin, end);
+  if (begin == end)
+    table.getRange(state, EPSILON, top, begin, end);
+  if (begin != end)
+    transition = *begin;
+  if (transition != NO_TRANSITION && automaton_.getEpsilonAnalysis().isDead(transition)) {
+    if (statistics_ != NULL)
+      statistics_->epsilonPrunes++;
+    return NO_TRANSITION;
+  }
+  return transition;
+}
+
+bool DeterministicRunner::finish (bool accepted, budget_t stopped) {
+  accepted_ = accepted;
+  stopped_ = stopped;
+  if (statistics_ != NULL) {
+    statistics_->expanded += moves_;
+    statistics_->maxStackDepth = max(statistics_->maxStackDepth, maxDepth_);
+    statistics_->maxFrontier = max(statistics_->maxFrontier, 1ul);
+    statistics_->depthPrunes += stopped == DEPTH_BUDGET;
+  }
+  return accepted_;
+}
+
+void DeterministicRunner::push (symbol_t symbol) {
+  weights_.push_back(min(getWeight() + automaton_.getEpsilonAnalysis().getWeight(symbol), MAX_WEIGHT));
+  stack_.push_back(symbol);
+  fingerprints_.push_back(SharedStack::mix(getFingerprint(), symbol));
+}
+
+// The stack can be emptied with the input left from the position, like in the search. A stream is read
+// ahead up to the weight of the stack, the heavier stacks are not cut.
+template <class Tape>
+bool DeterministicRunner::fits (Tape& tape, unsigned long pos) const {
+  unsigned weight = getWeight();
+  if (weight == 0 || weight > tape.getLookahead())
+    return weight < MAX_WEIGHT;
+  return tape.hasNext(pos + weight - 1);
+}
+
+// Same acceptance as the search: the input has to be read and the stack emptied in a final state, and
+// the automaton stops when the input ends or the stack is empty. A loop of e-transitions is detected
+// with Brent's algorithm, comparing against one saved configuration. Every move is one configuration
+// of the budget, the memory is the one of the stack.
+bool DeterministicRunner::run (const vector<symbol_t>& tape) {
+  VectorTape vectorTape (tape);
+  return runTape(vectorTape);
+}
+
+bool DeterministicRunner::run (TapeStream& tape) {
+  return runTape(tape);
+}
+
+template <class Tape>
+bool DeterministicRunner::runTape (Tape& tape) {
+  stack_.clear();
+  fingerprints_.clear();
+  weights_.clear();
+  moves_ = 0;
+  maxDepth_ = 0;
+  chrono::steady_clock::time_point deadline = config_.startDeadline();
+
+  symbol_t state = automaton_.getInitialState();
+  vector<symbol_t> initialStack = automaton_.getInitialStack();
+  for (unsigned i = 0; i < initialStack.size(); i++)
+    push(initialStack[i]);
+
+  unsigned long pos = 0;
+  symbol_t savedState = NO_SYMBOL;
+  unsigned savedSize = 0;
+  fingerprint_t savedFingerprint = 0;
+  unsigned long power = 1;
+  unsigned long length = 0;
+
+  while (true) {
+    maxDepth_ = max(maxDepth_, (unsigned) stack_.size());
+    if (!tape.hasNext(pos))
+      return finish(stack_.empty() && automaton_.isFinalState(state), NO_BUDGET);
+    if (stack_.empty())
+      return finish(false, NO_BUDGET);
+    if (!fits(tape, pos)) {
+      if (statistics_ != NULL)
+        statistics_->epsilonPrunes++;
+      return finish(false, NO_BUDGET);
+    }
+    if (stack_.size() > config_.getStackMaxDepth())
+      return finish(false, DEPTH_BUDGET);
+    if (moves_ >= config_.getMaxConfigurations())
+      return finish(false, CONFIGURATION_BUDGET);
+    if (moves_ % 4096 == 0) {
+      if (stack_.size() * (sizeof(symbol_t) + sizeof(fingerprint_t) + sizeof(unsigned)) > config_.getMaxMemory())
+        return finish(false, MEMORY_BUDGET);
+      if (chrono::steady_clock::now() > deadline)
+        return finish(false, TIME_BUDGET);
+    }
+
+    unsigned transition = findTransition(state, tape.getSymbol(pos), stack_.back());
+    if (transition == NO_TRANSITION)
+      return finish(false, NO_BUDGET);
+
+    stack_.pop_back();
+    fingerprints_.pop_back();
+    weights_.pop_back();
+    for (const symbol_t* symbol = automaton_.pushBegin(transition); symbol != automaton_.pushEnd(transition); symbol++)
+      push(*symbol);
+    state = automaton_.getTargetState(transition);
+    moves_++;
+    if (statistics_ != NULL)
+      statistics_->fired[transition]++;
+
+    if (automaton_.getTransitions()[transition].input != EPSILON) {
+      tape.release(++pos);
+      savedState = NO_SYMBOL;
+      power = 1;
+      length = 0;
+    }
+    else {
+      if (state == savedState && stack_.size() == savedSize && getFingerprint() == savedFingerprint) {
+        if (statistics_ != NULL)
+          statistics_->loopPrunes++;
+        return finish(false, NO_BUDGET);   // e-loop: the configuration repeats without reading the input.
+      }
+      if (++length == power) {
+        savedState = state;
+        savedSize = stack_.size();
+        savedFingerprint = getFingerprint();
+        power *= 2;
+        length = 0;
+      }
+    }
+  }
+}
@@ -0,0 +1,53 @@
+/***
+* @description: Runner for deterministic pushdown automata. There is at most one transition to take in
+*               every configuration, so the input is checked in a single pass without branches, passed
+*               points or history, using memory proportional to the depth of the stack. It only looks at the
+*               symbol being read, so it can also check a TapeStream while the input arrives.
+***/
+#ifndef _DETERMINISTIC_RUNNER_HPP_
+#define _DETERMINISTIC_RUNNER_HPP_
+#include <vector>
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+#include "RunConfig.hpp"
+#include "TapeStream.hpp"
+#include "SearchStatistics.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+class DeterministicRunner {
+  const PushDownAutomaton& automaton_;
+  const RunConfig& config_;
+  search_statistics_t* statistics_;   // Counters of the run, updated when it is not NULL.
+  vector<symbol_t> stack_;              // Bottom first.
+  vector<fingerprint_t> fingerprints_;  // Fingerprint of the stack up to every symbol, to detect e-loops.
+  vector<unsigned> weights_;            // Input needed to empty the stack up to every symbol.
+  unsigned long moves_;
+  unsigned maxDepth_;
+  budget_t stopped_;   // Budget that ran out.
+  bool accepted_;
+
+public:
+  DeterministicRunner (const PushDownAutomaton& automaton, const RunConfig& config);
+  ~DeterministicRunner ();
+
+  void setStatistics (search_statistics_t* statistics) { statistics_ = statistics; };
+  bool run (const vector<symbol_t>& tape);
+  bool run (TapeStream& tape);   // Online: every symbol is released once it is read.
+  check_result_t getResult () const { return makeResult(accepted_, stopped_, false); };
+  unsigned long getMoves () const { return moves_; };
+  unsigned getMaxDepth () const { return maxDepth_; };
+
+private:
+  template <class Tape> bool runTape (Tape& tape);
+  unsigned findTransition (symbol_t state, symbol_t symbol, symbol_t top) const;
+  void push (symbol_t symbol);
+  bool finish (bool accepted, budget_t stopped);
+  fingerprint_t getFingerprint () const { return fingerprints_.empty() ? EMPTY_FINGERPRINT : fingerprints_.back(); };
+  unsigned getWeight () const { return weights_.empty() ? 0 : weights_.back(); };
+  template <class Tape> bool fits (Tape& tape, unsigned long pos) const;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "EarleyRecognizer.hpp"
+
+
+// Bytes of an item with its entry in the set of added items.
+const unsigned long ITEM_MEMORY = 48;
+
+
+EarleyRecognizer::EarleyRecognizer (const Grammar& grammar, const RunConfig& config) : grammar_(grammar), config_(config) {
+  items_ = 0;
+  stopped_ = NO_BUDGET;
+  accepted_ = false;
+  dots_ = 1;
+  for (unsigned i = 0; i < grammar_.getProductions().size(); i++)
+    dots_ = max(dots_, (unsigned) grammar_.getProductions()[i].rhs.size() + 1);
+}
+
+EarleyRecognizer::~EarleyRecognizer () {}
+
+void EarleyRecognizer::add (unsigned set, unsigned production, unsigned dot, unsigned origin) {
+  unsigned long long key = (unsigned long long) origin * grammar_.getProductions().size() * dots_ +
+                           (unsigned long long) production * dots_ + dot;
+  if (!added_[set].insert(key).second)
+    return;
+
+  item_t item;
+  item.production = production;
+  item.dot = dot;
+  item.origin = origin;
+  sets_[set].push_back(item);
+  items_++;
+}
+
+// Nullable nonterminals are skipped when predicted (Aycock and Horspool), so completing an item never
+// has to look again at the set where it is being completed.
+bool EarleyRecognizer::recognize (const vector<symbol_t>& tape) {
+  const vector<production_t>& productions = grammar_.getProductions();
+  unsigned n = tape.size();
+  sets_.assign(n + 1, vector<item_t>());
+  added_.assign(n + 1, unordered_set<unsigned long long>());
+  items_ = 0;
+  chrono::steady_clock::time_point deadline = config_.startDeadline();
+  unsigned long processed = 0;
+
+  const vector<unsigned>& start = grammar_.getProductionsOf(grammar_.getStart());
+  for (unsigned i = 0; i < start.size(); i++)
+    add(0, start[i], 0, 0);
+
+  for (unsigned i = 0; i <= n; i++) {
+    for (unsigned j = 0; j < sets_[i].size(); j++) {
+      if (++processed % 1024 == 0) {
+        budget_t budget = checkBudgets(deadline);
+        if (budget != NO_BUDGET)
+          return finish(false, budget);
+      }
+      item_t item = sets_[i][j];
+      const production_t& production = productions[item.production];
+
+      if (item.dot < production.rhs.size()) {
+        gsymbol_t next = production.rhs[item.dot];
+        if (isTerminal(next)) {
+          // Scan
+          if (i < n && tape[i] == inputOf(next))
+            add(i + 1, item.production, item.dot + 1, item.origin);
+        }
+        else {
+          // Predict
+          const vector<unsigned>& alternatives = grammar_.getProductionsOf(next);
+          for (unsigned k = 0; k < alternatives.size(); k++)
+            add(i, alternatives[k], 0, i);
+          if (grammar_.isNullable(next))
+            add(i, item.production, item.dot + 1, item.origin);
+        }
+      }
+      else {
+        // Complete. An item predicted in this same set is nullable, its parents were already moved on.
+        if (item.origin == i)
+          continue;
+        const vector<item_t>& waiting = sets_[item.origin];
+        for (unsigned k = 0; k < waiting.size(); k++) {
+          const production_t& parent = productions[waiting[k].production];
+          if (waiting[k].dot < parent.rhs.size() && parent.rhs[waiting[k].dot] == (gsymbol_t) production.lhs)
+            add(i, waiting[k].production, waiting[k].dot + 1, waiting[k].origin);
+        }
+      }
+    }
+    if (i < n && sets_[i + 1].empty())
+      return finish(false, NO_BUDGET);   // No item can read the next symbol.
+  }
+
+  for (unsigned j = 0; j < sets_[n].size(); j++) {
+    const item_t& item = sets_[n][j];
+    if (item.origin == 0 && productions[item.production].lhs == grammar_.getStart() &&
+        item.dot == productions[item.production].rhs.size())
+      return finish(true, NO_BUDGET);
+  }
+  return finish(false, NO_BUDGET);
+}
+
+// Every item counts as a configuration.
+budget_t EarleyRecognizer::checkBudgets (chrono::steady_clock::time_point deadline) const {
+  if (items_ > config_.getMaxConfigurations())
+    return CONFIGURATION_BUDGET;
+  if (items_ * ITEM_MEMORY > config_.getMaxMemory())
+    return MEMORY_BUDGET;
+  if (chrono::steady_clock::now() > deadline)
+    return TIME_BUDGET;
+  return NO_BUDGET;
+}
+
+bool EarleyRecognizer::finish (bool accepted, budget_t stopped) {
+  accepted_ = accepted;
+  stopped_ = stopped;
+  return accepted_;
+}
@@ -0,0 +1,44 @@
+/***
+* @description: Earley recognizer. Decides if a tape of input symbol ids is derived by a grammar in
+*               O(n^3) time in the worst case and close to linear time for unambiguous grammars.
+***/
+#ifndef _EARLEY_RECOGNIZER_HPP_
+#define _EARLEY_RECOGNIZER_HPP_
+#include <vector>
+#include <unordered_set>
+#include "Grammar.hpp"
+#include "RunConfig.hpp"
+
+using namespace std;
+
+class EarleyRecognizer {
+  struct item_t {
+    unsigned production;
+    unsigned dot;      // Symbols of the right side already recognized.
+    unsigned origin;   // Set where the item was predicted.
+  };
+
+  const Grammar& grammar_;
+  const RunConfig& config_;
+  vector<vector<item_t> > sets_;
+  vector<unordered_set<unsigned long long> > added_;   // Items of every set, to add them only once.
+  unsigned long items_;
+  unsigned dots_;    // Possible positions of the dot in the longest production.
+  budget_t stopped_;
+  bool accepted_;
+
+public:
+  EarleyRecognizer (const Grammar& grammar, const RunConfig& config);
+  ~EarleyRecognizer ();
+
+  bool recognize (const vector<symbol_t>& tape);
+  unsigned long getItemCount () const { return items_; };
+  check_result_t getResult () const { return makeResult(accepted_, stopped_, false); };
+
+private:
+  void add (unsigned set, unsigned production, unsigned dot, unsigned origin);
+  budget_t checkBudgets (chrono::steady_clock::time_point deadline) const;
+  bool finish (bool accepted, budget_t stopped);
+};
+
+#endif
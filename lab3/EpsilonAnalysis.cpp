@@ -0,0 +1,407 @@
+#include "EpsilonAnalysis.hpp"
+#include "PushDownAutomaton.hpp"
+#include <cstring>
+
+// Edge between two pairs (state, top) followed by e-transitions, it grows the stack when the transition
+// leaves symbols below the new top.
+struct pair_edge_t {
+  unsigned from;
+  unsigned to;
+  unsigned transition;
+  bool grows;
+};
+
+// Flags of a transition in an image.
+const unsigned DEAD_FLAG = 1;
+const unsigned GROWING_FLAG = 2;
+const unsigned TRANSPARENT_FLAG = 4;
+
+EpsilonAnalysis::EpsilonAnalysis () {
+  states_ = 0;
+  symbols_ = 0;
+  words_ = 0;
+  inputs_ = 0;
+  inputWords_ = 0;
+  work_ = 0;
+  complete_ = false;
+}
+
+EpsilonAnalysis::~EpsilonAnalysis () {}
+
+void EpsilonAnalysis::analyse (const PushDownAutomaton& automaton) {
+  const vector<transition_t>& transitions = automaton.getTransitions();
+  states_ = automaton.getStates().size();
+  symbols_ = automaton.getStackSymbols().size();
+  words_ = (states_ + 63) / 64;
+  inputs_ = automaton.getInputSymbols().size();
+  inputWords_ = (inputs_ + 63) / 64;
+  sources_.resize(transitions.size());
+  targetStates_.resize(transitions.size());
+  pushes_.resize(transitions.size());
+
+  // Transitions with unknown states or tops are left out of the analysis.
+  vector<bool> valid (transitions.size());
+  vector<bool> epsilon (transitions.size());
+  for (unsigned t = 0; t < transitions.size(); t++) {
+    automaton.readTarget(t, targetStates_[t], pushes_[t]);
+    reverse(pushes_[t].begin(), pushes_[t].end());
+    valid[t] = transitions[t].state < states_ && transitions[t].top < symbols_ && targetStates_[t] < states_;
+    epsilon[t] = valid[t] && transitions[t].input == EPSILON;
+    sources_[t] = valid[t] ? getPair(transitions[t].state, transitions[t].top) : 0;
+  }
+
+  // The sets of the pairs are dense, so they are only allocated when they fit in the work budget too. If
+  // not the analysis gives up before starting, the same as when the work runs out.
+  unsigned long long pairs = (unsigned long long) states_ * symbols_;
+  work_ = 0;
+  complete_ = pairs * max(words_, 1u) <= ANALYSIS_WORK && pairs * inputWords_ <= ANALYSIS_WORK &&
+              getStartsSize(transitions.size(), inputs_) / 2 <= ANALYSIS_WORK;
+  if (complete_)
+    findPops(epsilon);
+  if (complete_)
+    findReads(transitions, valid, epsilon);
+  if (complete_)
+    findDead(valid);
+  if (complete_)
+    findGrowing(epsilon);
+  if (complete_)
+    findFirsts(transitions, valid, epsilon);
+
+  findWeights(transitions, valid);
+  if (!complete_) {
+    dead_.assign(transitions.size(), false);
+    growing_.assign(transitions.size(), false);
+    transparent_.assign(transitions.size(), true);
+  }
+  firsts_ = vector<word_t>();
+  sources_ = vector<unsigned>();
+  targetStates_ = vector<symbol_t>();
+  pushes_ = vector<vector<symbol_t> >();
+}
+
+// The symbols read first are only stored when the analysis is complete, they are not used otherwise.
+void EpsilonAnalysis::store (vector<unsigned>& flags, vector<unsigned>& starts, vector<unsigned>& weights) const {
+  flags.assign(dead_.size(), 0);
+  for (unsigned t = 0; t < dead_.size(); t++)
+    flags[t] = (dead_[t] ? DEAD_FLAG : 0) | (growing_[t] ? GROWING_FLAG : 0) | (transparent_[t] ? TRANSPARENT_FLAG : 0);
+  starts.assign(complete_ ? starts_.size() * 2 : 0, 0);
+  memcpy(starts.data(), starts_.data(), starts.size() * sizeof(unsigned));
+  weights = weights_;
+}
+
+void EpsilonAnalysis::restore (unsigned transitions, unsigned inputs, unsigned stackSymbols, bool complete,
+                               const unsigned* flags, const unsigned* starts, const unsigned* weights) {
+  inputs_ = inputs;
+  inputWords_ = (inputs_ + 63) / 64;
+  complete_ = complete;
+  dead_.resize(transitions);
+  growing_.resize(transitions);
+  transparent_.resize(transitions);
+  for (unsigned t = 0; t < transitions; t++) {
+    dead_[t] = complete_ && (flags[t] & DEAD_FLAG);
+    growing_[t] = complete_ && (flags[t] & GROWING_FLAG);
+    transparent_[t] = !complete_ || (flags[t] & TRANSPARENT_FLAG);
+  }
+  starts_.assign(complete_ ? getStartsSize(transitions, inputs) / 2 : 0, 0);
+  memcpy(starts_.data(), starts, starts_.size() * sizeof(word_t));
+  weights_.assign(weights, weights + stackSymbols);
+}
+
+// Minimum yield of every stack symbol, like the shortest word of a nonterminal: a transition costs the
+// symbol it reads and the weights of what it pushes, from any state. It is at least 1 for a symbol that no
+// state can pop with e-transitions only. The weights only go down until they are the minimum, so if the
+// work runs out before they are all weights are 0 and nothing is cut by them.
+void EpsilonAnalysis::findWeights (const vector<transition_t>& transitions, const vector<bool>& valid) {
+  weights_.assign(symbols_, MAX_WEIGHT);
+  unsigned long work = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned t = 0; t < transitions.size(); t++) {
+      if (!valid[t])
+        continue;
+      work += 1 + pushes_[t].size();
+      if (work >= ANALYSIS_WORK) {
+        weights_.assign(symbols_, 0);
+        return;
+      }
+      unsigned cost = transitions[t].input != EPSILON ? 1 : 0;
+      for (unsigned i = 0; i < pushes_[t].size() && cost < MAX_WEIGHT; i++)
+        cost = min(cost + weights_[pushes_[t][i]], MAX_WEIGHT);
+      if (cost < weights_[transitions[t].top]) {
+        weights_[transitions[t].top] = cost;
+        changed = true;
+      }
+    }
+  }
+
+  if (!complete_)
+    return;
+  for (symbol_t top = 0; top < symbols_; top++) {
+    bool pops = false;
+    for (symbol_t state = 0; state < states_ && !pops; state++)
+      for (unsigned w = 0; w < words_; w++)
+        pops = pops || pops_[(unsigned long) getPair(state, top) * words_ + w] != 0;
+    if (!pops)
+      weights_[top] = max(weights_[top], 1u);
+  }
+}
+
+unsigned EpsilonAnalysis::getDeadCount () const {
+  return count(dead_.begin(), dead_.end(), true);
+}
+
+unsigned EpsilonAnalysis::getGrowingCount () const {
+  return count(growing_.begin(), growing_.end(), true);
+}
+
+// States where the first symbols pushed by the transition (from the top) have been popped with
+// e-transitions only. False if there is none.
+bool EpsilonAnalysis::popChain (unsigned transition, vector<word_t>& states, unsigned symbols) const {
+  states.assign(words_, 0);
+  states[targetStates_[transition] / 64] |= 1ULL << (targetStates_[transition] % 64);
+  vector<word_t> next (words_);
+  for (unsigned i = 0; i < symbols; i++) {
+    fill(next.begin(), next.end(), 0);
+    bool any = false;
+    for (unsigned word = 0; word < words_; word++)
+      for (word_t bits = states[word]; bits != 0; bits &= bits - 1) {
+        symbol_t state = word * 64 + __builtin_ctzll(bits);
+        const word_t* row = &pops_[(unsigned long) getPair(state, pushes_[transition][i]) * words_];
+        work_ += words_;
+        for (unsigned w = 0; w < words_; w++) {
+          next[w] |= row[w];
+          any = any || row[w] != 0;
+        }
+      }
+    states.swap(next);
+    if (!any)
+      return false;
+  }
+  return true;
+}
+
+// The states where a top is popped grow until no e-transition adds one.
+void EpsilonAnalysis::findPops (const vector<bool>& epsilon) {
+  pops_.assign((unsigned long) states_ * symbols_ * words_, 0);
+  vector<word_t> states;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned t = 0; t < epsilon.size(); t++) {
+      if (!hasWork())
+        return;
+      if (!epsilon[t] || !popChain(t, states, pushes_[t].size()))
+        continue;
+      word_t* row = &pops_[(unsigned long) sources_[t] * words_];
+      for (unsigned w = 0; w < words_; w++)
+        if (states[w] & ~row[w]) {
+          row[w] |= states[w];
+          changed = true;
+        }
+    }
+  }
+}
+
+// The input can be read from the target of the transition before the symbols it pushes are popped.
+bool EpsilonAnalysis::canRead (unsigned transition) const {
+  vector<word_t> states;
+  for (unsigned i = 0; i < pushes_[transition].size(); i++) {
+    if (!popChain(transition, states, i))
+      return false;
+    for (unsigned word = 0; word < words_; word++)
+      for (word_t bits = states[word]; bits != 0; bits &= bits - 1)
+        if (reads_[getPair(word * 64 + __builtin_ctzll(bits), pushes_[transition][i])])
+          return true;
+  }
+  return false;
+}
+
+// A pair reads if it has a transition that reads, or an e-transition whose target reads.
+void EpsilonAnalysis::findReads (const vector<transition_t>& transitions, const vector<bool>& valid,
+                                 const vector<bool>& epsilon) {
+  reads_.assign((unsigned long) states_ * symbols_, false);
+  for (unsigned t = 0; t < transitions.size(); t++)
+    if (valid[t] && !epsilon[t])
+      reads_[sources_[t]] = true;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned t = 0; t < epsilon.size() && hasWork(); t++)
+      if (epsilon[t] && !reads_[sources_[t]] && canRead(t)) {
+        reads_[sources_[t]] = true;
+        changed = true;
+      }
+  }
+}
+
+// The search only stops with an empty stack or at the end of the input, and it can only get to the end
+// by reading. A transition that pushes symbols which can't be read from nor popped does neither.
+void EpsilonAnalysis::findDead (const vector<bool>& valid) {
+  dead_.assign(valid.size(), false);
+  vector<word_t> states;
+  for (unsigned t = 0; t < valid.size() && hasWork(); t++)
+    dead_[t] = valid[t] && !pushes_[t].empty() && !canRead(t) && !popChain(t, states, pushes_[t].size());
+}
+
+// e-transitions that go back to the pair they start from with more symbols below: they belong to a
+// strongly connected component of the graph of pairs and one of their edges grows the stack.
+void EpsilonAnalysis::findGrowing (const vector<bool>& epsilon) {
+  unsigned pairs = states_ * symbols_;
+  vector<pair_edge_t> edges;
+  vector<word_t> states;
+  for (unsigned t = 0; t < epsilon.size(); t++) {
+    if (!hasWork())
+      return;
+    if (!epsilon[t])
+      continue;
+    for (unsigned i = 0; i < pushes_[t].size(); i++) {
+      if (!popChain(t, states, i))
+        break;
+      for (unsigned word = 0; word < words_; word++)
+        for (word_t bits = states[word]; bits != 0; bits &= bits - 1) {
+          pair_edge_t edge;
+          edge.from = sources_[t];
+          edge.to = getPair(word * 64 + __builtin_ctzll(bits), pushes_[t][i]);
+          edge.transition = t;
+          edge.grows = i + 1 < pushes_[t].size();
+          edges.push_back(edge);
+          work_++;
+        }
+    }
+  }
+
+  // Kosaraju: finishing order on the graph, then components on the reversed one.
+  vector<unsigned> start (pairs + 1, 0), reverseStart (pairs + 1, 0);
+  for (unsigned e = 0; e < edges.size(); e++) {
+    start[edges[e].from + 1]++;
+    reverseStart[edges[e].to + 1]++;
+  }
+  for (unsigned p = 0; p < pairs; p++) {
+    start[p + 1] += start[p];
+    reverseStart[p + 1] += reverseStart[p];
+  }
+  vector<unsigned> next (start.begin(), start.end() - 1), reverseNext (reverseStart.begin(), reverseStart.end() - 1);
+  vector<unsigned> out (edges.size()), in (edges.size());
+  for (unsigned e = 0; e < edges.size(); e++) {
+    out[next[edges[e].from]++] = edges[e].to;
+    in[reverseNext[edges[e].to]++] = edges[e].from;
+  }
+
+  vector<unsigned> order;
+  vector<bool> seen (pairs, false);
+  vector<pair<unsigned, unsigned> > path;   // Pair and next edge to follow.
+  for (unsigned root = 0; root < pairs; root++) {
+    if (seen[root])
+      continue;
+    seen[root] = true;
+    path.push_back(make_pair(root, start[root]));
+    while (!path.empty()) {
+      unsigned pair = path.back().first;
+      if (path.back().second == start[pair + 1]) {
+        order.push_back(pair);
+        path.pop_back();
+        continue;
+      }
+      unsigned to = out[path.back().second++];
+      if (!seen[to]) {
+        seen[to] = true;
+        path.push_back(make_pair(to, start[to]));
+      }
+    }
+  }
+
+  const unsigned NO_COMPONENT = ~0u;
+  vector<unsigned> component (pairs, NO_COMPONENT);
+  vector<unsigned> pending;
+  for (unsigned i = order.size(); i > 0; i--) {
+    unsigned root = order[i - 1];
+    if (component[root] != NO_COMPONENT)
+      continue;
+    component[root] = root;
+    pending.push_back(root);
+    while (!pending.empty()) {
+      unsigned pair = pending.back();
+      pending.pop_back();
+      for (unsigned e = reverseStart[pair]; e < reverseStart[pair + 1]; e++)
+        if (component[in[e]] == NO_COMPONENT) {
+          component[in[e]] = root;
+          pending.push_back(in[e]);
+        }
+    }
+  }
+
+  growing_.assign(epsilon.size(), false);
+  for (unsigned e = 0; e < edges.size(); e++)
+    if (edges[e].grows && component[edges[e].from] == component[edges[e].to])
+      growing_[edges[e].transition] = true;
+}
+
+// Input symbols the transition can read first: the ones of the pairs of its pushed symbols, from the top,
+// while the symbols above them can be popped without reading. True if all of them can.
+bool EpsilonAnalysis::firstChain (unsigned transition, vector<word_t>& symbols) const {
+  symbols.assign(inputWords_, 0);
+  vector<word_t> states (words_, 0);
+  states[targetStates_[transition] / 64] |= 1ULL << (targetStates_[transition] % 64);
+  vector<word_t> next (words_);
+  for (unsigned i = 0; i < pushes_[transition].size(); i++) {
+    fill(next.begin(), next.end(), 0);
+    bool any = false;
+    for (unsigned word = 0; word < words_; word++)
+      for (word_t bits = states[word]; bits != 0; bits &= bits - 1) {
+        unsigned pair = getPair(word * 64 + __builtin_ctzll(bits), pushes_[transition][i]);
+        const word_t* row = &pops_[(unsigned long) pair * words_];
+        const word_t* first = &firsts_[(unsigned long) pair * inputWords_];
+        work_ += words_ + inputWords_;
+        for (unsigned w = 0; w < inputWords_; w++)
+          symbols[w] |= first[w];
+        for (unsigned w = 0; w < words_; w++) {
+          next[w] |= row[w];
+          any = any || row[w] != 0;
+        }
+      }
+    states.swap(next);
+    if (!any)
+      return false;
+  }
+  return true;
+}
+
+// The symbols of a pair are the ones its transitions read and the first ones of its e-transitions, until
+// no pair gets more. Then every e-transition keeps its own.
+void EpsilonAnalysis::findFirsts (const vector<transition_t>& transitions, const vector<bool>& valid,
+                                  const vector<bool>& epsilon) {
+  firsts_.assign((unsigned long) states_ * symbols_ * inputWords_, 0);
+  for (unsigned t = 0; t < transitions.size(); t++)
+    if (valid[t] && !epsilon[t] && transitions[t].input < inputs_)
+      firsts_[(unsigned long) sources_[t] * inputWords_ + transitions[t].input / 64] |= 1ULL << (transitions[t].input % 64);
+
+  vector<word_t> symbols;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned t = 0; t < epsilon.size(); t++) {
+      if (!hasWork())
+        return;
+      if (!epsilon[t])
+        continue;
+      firstChain(t, symbols);
+      word_t* row = &firsts_[(unsigned long) sources_[t] * inputWords_];
+      for (unsigned w = 0; w < inputWords_; w++)
+        if (symbols[w] & ~row[w]) {
+          row[w] |= symbols[w];
+          changed = true;
+        }
+    }
+  }
+
+  starts_.assign((unsigned long) epsilon.size() * inputWords_, 0);
+  transparent_.assign(epsilon.size(), true);
+  for (unsigned t = 0; t < epsilon.size() && hasWork(); t++) {
+    if (!epsilon[t])
+      continue;
+    transparent_[t] = firstChain(t, symbols);
+    copy(symbols.begin(), symbols.end(), starts_.begin() + (unsigned long) t * inputWords_);
+  }
+}
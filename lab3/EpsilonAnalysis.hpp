@@ -0,0 +1,86 @@
+/***
+* @description: Analysis of the e-transitions of an automaton over the pairs (state, stack top), done once
+*               when it is loaded. It finds the transitions after which the input can never be read again,
+*               the e-transitions on cycles that grow the stack without reading, and the input every stack
+*               symbol needs at least to be popped. A stack that needs more input than what is left can't
+*               be emptied, which bounds the search by the length of the input. Like the FIRST sets of a grammar,
+*               it also finds the input symbols every e-transition can read first, so the ones that can't
+*               read the next symbol of the tape are not taken. The results are kept in the compiled
+*               image of the automaton, so loading it doesn't analyse it again.
+***/
+#ifndef _EPSILON_ANALYSIS_HPP_
+#define _EPSILON_ANALYSIS_HPP_
+#include <vector>
+#include "SymbolTable.hpp"
+#include "TransitionTable.hpp"
+#include "SharedStack.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+const unsigned long ANALYSIS_WORK = 1ul << 23;   // Words of state sets the analysis can go through.
+
+class EpsilonAnalysis {
+  typedef unsigned long long word_t;
+
+  unsigned states_;
+  unsigned symbols_;
+  unsigned words_;                  // Words of a set of states.
+  unsigned inputs_;
+  unsigned inputWords_;             // Words of a set of input symbols.
+  vector<unsigned> sources_;        // By transition: its pair (state, top).
+  vector<symbol_t> targetStates_;
+  vector<vector<symbol_t> > pushes_;   // Top first.
+  vector<word_t> pops_;             // By (state, top): states where the top is popped with e-transitions only.
+  vector<bool> reads_;              // By (state, top): the input can be read before the top is popped.
+  vector<word_t> firsts_;           // By (state, top): input symbols that can be read first, before the top is popped.
+  vector<word_t> starts_;           // By transition: input symbols read first, before what it pushes is popped.
+  vector<bool> transparent_;        // By transition: what it pushes can be popped without reading.
+  vector<bool> dead_;               // By transition.
+  vector<bool> growing_;            // By transition.
+  vector<unsigned> weights_;        // By stack symbol: input symbols read at least to pop it, MAX_WEIGHT if it can't be.
+  mutable unsigned long work_;
+  bool complete_;                   // False if the automaton was too big to analyse, nothing is cut then.
+
+public:
+  EpsilonAnalysis ();
+  ~EpsilonAnalysis ();
+
+  void analyse (const PushDownAutomaton& automaton);
+  // Results as the sections of an image: flags by transition, the symbols every transition reads first
+  // (as halves of the words of a set) and the weights. A restored image has been checked to have their sizes.
+  void store (vector<unsigned>& flags, vector<unsigned>& starts, vector<unsigned>& weights) const;
+  void restore (unsigned transitions, unsigned inputs, unsigned stackSymbols, bool complete, const unsigned* flags,
+                const unsigned* starts, const unsigned* weights);
+  static unsigned long long getStartsSize (unsigned transitions, unsigned inputs) { return 2ull * transitions * ((inputs + 63) / 64); };
+
+  // After the transition there is nothing left to read or to pop without reading, so the search can't
+  // get to the end of the input from there.
+  bool isDead (unsigned transition) const { return dead_[transition]; };
+  bool isGrowing (unsigned transition) const { return growing_[transition]; };
+  unsigned getWeight (symbol_t symbol) const { return symbol < weights_.size() ? weights_[symbol] : 0; };
+  // The transition can read the symbol as the next one, always true when the symbol can come from below.
+  bool canStart (unsigned transition, symbol_t symbol) const {
+    return transparent_[transition] ||
+           (symbol < inputs_ && (starts_[(unsigned long) transition * inputWords_ + symbol / 64] >> (symbol % 64) & 1));
+  };
+  unsigned getDeadCount () const;
+  unsigned getGrowingCount () const;
+  bool isComplete () const { return complete_; };
+
+private:
+  unsigned getPair (symbol_t state, symbol_t top) const { return state * symbols_ + top; };
+  bool hasWork () { complete_ = complete_ && work_ < ANALYSIS_WORK; return complete_; };
+  bool popChain (unsigned transition, vector<word_t>& states, unsigned symbols) const;
+  void findPops (const vector<bool>& epsilon);
+  bool canRead (unsigned transition) const;
+  void findReads (const vector<transition_t>& transitions, const vector<bool>& valid, const vector<bool>& epsilon);
+  void findDead (const vector<bool>& valid);
+  void findGrowing (const vector<bool>& epsilon);
+  void findWeights (const vector<transition_t>& transitions, const vector<bool>& valid);
+  bool firstChain (unsigned transition, vector<word_t>& symbols) const;
+  void findFirsts (const vector<transition_t>& transitions, const vector<bool>& valid, const vector<bool>& epsilon);
+};
+
+#endif
@@ -0,0 +1,253 @@
+#include "Grammar.hpp"
+#include "PushDownAutomaton.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+
+Grammar::Grammar () {
+  start_ = 0;
+}
+
+// Triple construction. The automaton accepts by final state and empty stack, so the start symbol derives
+// [q0,Z,f]' for every final state f. Only the triples reachable from the start symbol are built.
+Grammar::Grammar (const PushDownAutomaton& automaton) {
+  const SymbolTable& states = automaton.getStates();
+  const SymbolTable& stackSymbols = automaton.getStackSymbols();
+  const vector<transition_t>& transitions = automaton.getTransitions();
+  unsigned nStates = states.size();
+  unsigned nStack = stackSymbols.size();
+  bool singleState = nStates == 1;
+
+  const SymbolTable& inputs = automaton.getInputSymbols();
+  for (unsigned i = 0; i < inputs.size(); i++)
+    terminals_.push_back(inputs.name(i));
+
+  // Transitions by (state, top) and their targets. Only the pairs with transitions are kept.
+  unordered_map<unsigned long long, vector<unsigned> > from;
+  vector<symbol_t> targetState (transitions.size());
+  vector<vector<symbol_t> > targetPush (transitions.size());
+  for (unsigned i = 0; i < transitions.size(); i++) {
+    from[(unsigned long long) transitions[i].state * nStack + transitions[i].top].push_back(i);
+    automaton.readTarget(i, targetState[i], targetPush[i]);
+  }
+
+  // Triple (p, A, q) -> nonterminal id, created on demand. The search makes no move once the input is
+  // read, so the last move of an accepted input reads a symbol: the primed triple [p,A,q]' only derives
+  // the inputs whose last move reads one, and it is used for the bottom of the stack. The triples are
+  // kept in a map, so the memory grows with the reachable ones and not with nStates^2 * nStack.
+  unordered_map<unsigned long long, unsigned> triple;
+  vector<unsigned long long> pending;
+  auto nonterminalOf = [&] (symbol_t p, symbol_t A, symbol_t q, bool last) {
+    unsigned long long key = (((unsigned long long) p * nStack + A) * nStates + q) * 2 + last;
+    auto found = triple.find(key);
+    if (found != triple.end())
+      return found->second;
+    string name = singleState ? stackSymbols.name(A)
+                              : "[" + states.name(p) + "," + stackSymbols.name(A) + "," + states.name(q) + "]";
+    unsigned id = addNonterminal(last ? name + "'" : name);
+    triple[key] = id;
+    pending.push_back(key);
+    return id;
+  };
+  // Adds lhs -> prefix [r,B1,s1] [s1,B2,s2] ... [s(k-1),Bk,q] for every choice of the middle states, with
+  // the symbols given from the top. The last triple is primed if asked.
+  auto addChains = [&] (unsigned lhs, const vector<gsymbol_t>& prefix, symbol_t r, const vector<symbol_t>& symbols,
+                        symbol_t q, bool last) {
+    unsigned k = symbols.size();
+    vector<symbol_t> middle (k - 1, 0);
+    while (true) {
+      vector<gsymbol_t> full = prefix;
+      symbol_t s = r;
+      for (unsigned j = 0; j < k; j++) {
+        symbol_t next = j + 1 < k ? middle[j] : q;
+        full.push_back(nonterminalOf(s, symbols[j], next, last && j + 1 == k));
+        s = next;
+      }
+      addProduction(lhs, full);
+
+      unsigned j = 0;
+      while (j < middle.size() && ++middle[j] == nStates)
+        middle[j++] = 0;
+      if (j == middle.size())
+        break;
+    }
+  };
+
+  start_ = addNonterminal("S'");
+  vector<symbol_t> initialStack = automaton.getInitialStack();   // The top is the last one.
+  reverse(initialStack.begin(), initialStack.end());
+  if (!initialStack.empty())
+    for (symbol_t f = 0; f < nStates; f++)
+      if (automaton.isFinalState(f))
+        addChains(start_, vector<gsymbol_t>(), automaton.getInitialState(), initialStack, f, true);
+
+  while (!pending.empty()) {
+    unsigned long long key = pending.back();
+    pending.pop_back();
+    unsigned lhs = triple[key];
+    bool last = key % 2;
+    key /= 2;
+    symbol_t q = key % nStates;
+    symbol_t A = (key / nStates) % nStack;
+    symbol_t p = key / nStates / nStack;
+
+    auto found = from.find((unsigned long long) p * nStack + A);
+    if (found == from.end())
+      continue;
+    const vector<unsigned>& moves = found->second;
+    for (unsigned m = 0; m < moves.size(); m++) {
+      const transition_t& transition = transitions[moves[m]];
+      const vector<symbol_t>& push = targetPush[moves[m]];   // The new top is the last one.
+      symbol_t r = targetState[moves[m]];
+      if (r == NO_SYMBOL)
+        continue;
+
+      vector<gsymbol_t> rhs;
+      if (transition.input != EPSILON)
+        rhs.push_back(terminalOf(transition.input));
+
+      // A pop is the last move of [p,A,q]', so it has to read a symbol there.
+      if (push.empty()) {
+        if (r == q && (!last || transition.input != EPSILON))
+          addProduction(lhs, rhs);
+        continue;
+      }
+
+      // [p,A,q] -> x [r,B1,s1] [s1,B2,s2] ... [s(k-1),Bk,q], the last move is the one of [s(k-1),Bk,q].
+      addChains(lhs, rhs, r, vector<symbol_t>(push.rbegin(), push.rend()), q, last);
+    }
+  }
+
+  computeNullable();
+}
+
+Grammar::~Grammar () {}
+
+// Lines that are not blank or comments ("#").
+static bool readRule (ifstream& file, string& line) {
+  while (getline(file, line)) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first != string::npos && line[first] != '#')
+      return true;
+  }
+  return false;
+}
+
+bool Grammar::isGrammarFile (string fileName) {
+  ifstream file (fileName.c_str());
+  string line;
+  return readRule(file, line) && line.find("->") != string::npos;
+}
+
+// Every character of a right side but the blanks is a symbol, so the nonterminals are known before
+// the right sides are read. The start symbol S' derives the start symbol of the file.
+bool Grammar::load (string fileName, SymbolTable& inputs) {
+  ifstream file (fileName.c_str());
+  vector<string> lefts;
+  vector<string> rights;
+  string line;
+  while (readRule(file, line)) {
+    size_t arrow = line.find("->");
+    vector<string> left = utils::lineToStrings(line.substr(0, arrow == string::npos ? 0 : arrow), " \t");
+    if (arrow == string::npos || left.size() != 1 || left[0].size() != 1 || left[0] == "e") {
+      cerr << "Wrong grammar rule: " << line << endl;
+      return false;
+    }
+    lefts.push_back(left[0]);
+    rights.push_back(line.substr(arrow + 2));
+  }
+  if (lefts.empty()) {
+    cerr << "The grammar has no rules: " << fileName << endl;
+    return false;
+  }
+
+  start_ = addNonterminal("S'");
+  vector<int> nonterminalOf (256, -1);
+  for (unsigned i = 0; i < lefts.size(); i++)
+    if (nonterminalOf[(unsigned char) lefts[i][0]] < 0)
+      nonterminalOf[(unsigned char) lefts[i][0]] = addNonterminal(lefts[i]);
+  addProduction(start_, vector<gsymbol_t>(1, nonterminalOf[(unsigned char) lefts[0][0]]));
+
+  for (unsigned i = 0; i < rights.size(); i++) {
+    vector<string> alternatives = utils::lineToStrings(rights[i], "|");
+    if (alternatives.empty())
+      alternatives.push_back("e");
+    for (unsigned j = 0; j < alternatives.size(); j++) {
+      vector<gsymbol_t> rhs;
+      vector<string> symbols = utils::lineToStrings(alternatives[j], " \t\r");
+      string word;
+      for (unsigned k = 0; k < symbols.size(); k++)
+        word += symbols[k];
+      if (word == "e")
+        word = "";
+      for (unsigned k = 0; k < word.size(); k++) {
+        int nonterminal = nonterminalOf[(unsigned char) word[k]];
+        if (nonterminal >= 0)
+          rhs.push_back(nonterminal);
+        else if (word[k] == 'e') {
+          cerr << "The empty word \"e\" can't be part of a right side: " << alternatives[j] << endl;
+          return false;
+        }
+        else
+          rhs.push_back(terminalOf(inputs.intern(string(1, word[k]))));
+      }
+      addProduction(nonterminalOf[(unsigned char) lefts[i][0]], rhs);
+    }
+  }
+
+  terminals_.clear();
+  for (unsigned i = 0; i < inputs.size(); i++)
+    terminals_.push_back(inputs.name(i));
+  computeNullable();
+  return true;
+}
+
+unsigned Grammar::addNonterminal (const string& name) {
+  nonterminals_.push_back(name);
+  byLhs_.push_back(vector<unsigned>());
+  return nonterminals_.size() - 1;
+}
+
+void Grammar::addProduction (unsigned lhs, const vector<gsymbol_t>& rhs) {
+  production_t production;
+  production.lhs = lhs;
+  production.rhs = rhs;
+  productions_.push_back(production);
+  byLhs_[lhs].push_back(productions_.size() - 1);
+}
+
+void Grammar::computeNullable () {
+  nullable_.assign(nonterminals_.size(), false);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned i = 0; i < productions_.size(); i++) {
+      if (nullable_[productions_[i].lhs])
+        continue;
+      bool all = true;
+      for (unsigned j = 0; j < productions_[i].rhs.size() && all; j++)
+        all = !isTerminal(productions_[i].rhs[j]) && nullable_[productions_[i].rhs[j]];
+      if (all) {
+        nullable_[productions_[i].lhs] = true;
+        changed = true;
+      }
+    }
+  }
+}
+
+const string Grammar::symbolName (gsymbol_t symbol) const {
+  if (isTerminal(symbol))
+    return inputOf(symbol) < terminals_.size() ? terminals_[inputOf(symbol)] : "?";
+  return nonterminals_[symbol];
+}
+
+const void Grammar::show () const {
+  for (unsigned i = 0; i < productions_.size(); i++) {
+    cout << nonterminals_[productions_[i].lhs] << " ->";
+    if (productions_[i].rhs.empty())
+      cout << " e";
+    for (unsigned j = 0; j < productions_[i].rhs.size(); j++)
+      cout << " " << symbolName(productions_[i].rhs[j]);
+    cout << endl;
+  }
+}
@@ -0,0 +1,63 @@
+/***
+* @description: Context-free grammar of the language of a pushdown automaton, built with the triple
+*               construction: the nonterminal [p,A,q] derives the inputs that take the automaton from
+*               state p to state q popping A, and [p,A,q]' the ones whose last move reads a symbol, like
+*               the search accepts. For single-state automata [q,A,q] is just A.
+*               A grammar can also be read from a grammar file, one rule per line like "E -> E+T | T":
+*               the symbols are single characters, the ones on the left are the nonterminals, "e" is the
+*               empty word and the first rule is the one of the start symbol.
+***/
+#ifndef _GRAMMAR_HPP_
+#define _GRAMMAR_HPP_
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+typedef int gsymbol_t;   // Nonterminals are >= 0, terminals are -1 - (input symbol id).
+
+inline bool isTerminal (gsymbol_t symbol) { return symbol < 0; }
+inline gsymbol_t terminalOf (symbol_t input) { return -1 - (int) input; }
+inline symbol_t inputOf (gsymbol_t terminal) { return -1 - terminal; }
+
+struct production_t {
+  unsigned lhs;
+  vector<gsymbol_t> rhs;
+};
+
+class Grammar {
+  vector<string> nonterminals_;        // Names of the nonterminals.
+  vector<string> terminals_;           // Names of the input symbols, by id.
+  vector<production_t> productions_;
+  vector<vector<unsigned> > byLhs_;    // Productions of every nonterminal.
+  vector<bool> nullable_;
+  unsigned start_;
+
+public:
+  Grammar ();
+  Grammar (const PushDownAutomaton& automaton);
+  ~Grammar ();
+
+  static bool isGrammarFile (string fileName);   // The first rule has an arrow.
+  bool load (string fileName, SymbolTable& inputs);   // The terminals are interned as input symbols.
+  unsigned addNonterminal (const string& name);
+  void addProduction (unsigned lhs, const vector<gsymbol_t>& rhs);
+  void setStart (unsigned start) { start_ = start; };
+  void computeNullable ();
+
+  unsigned getStart () const { return start_; };
+  unsigned getNonterminalCount () const { return nonterminals_.size(); };
+  unsigned getTerminalCount () const { return terminals_.size(); };
+  const vector<production_t>& getProductions () const { return productions_; };
+  const vector<unsigned>& getProductionsOf (unsigned nonterminal) const { return byLhs_[nonterminal]; };
+  bool isNullable (unsigned nonterminal) const { return nullable_[nonterminal]; };
+  const string symbolName (gsymbol_t symbol) const;
+  const void show () const;
+};
+
+#endif
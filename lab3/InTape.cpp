@@ -1,14 +1,15 @@
 #include "InTape.hpp"
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 
 
 InTape::InTape () {}
 
-InTape::InTape (string fileName) {
-  loadFromFile (fileName);
+InTape::InTape (string fileName, const Tokenizer& tokenizer) {
+  loadFromFile (fileName, tokenizer);
 }
 
 
@@ -16,19 +17,17 @@ InTape::~InTape (){
    chars_.clear();
 }
 
-void InTape::loadFromFile (string fileName) {
+void InTape::loadFromFile (string fileName, const Tokenizer& tokenizer) {
   reset();
-  inx_ = 0;
   fstream file;
-  string symbol;
   fileName_ = fileName;
   file.open(fileName.c_str(), ios::in);
 
   if(file.good()) {
-      chars_.clear();
-      while(file >> symbol){
-        chars_.push_back(symbol);
-    }
+    stringstream buffer;
+    buffer << file.rdbuf();
+    text_ = buffer.str();
+    tokenizer.split(text_, chars_);
     file.close();
   }
   else{
@@ -37,46 +36,30 @@ void InTape::loadFromFile (string fileName) {
 }
 
 
-void InTape::loadFromKeyboard () {
+void InTape::loadFromKeyboard (const Tokenizer& tokenizer) {
   reset();
-  string input;
   cout << "Put string as input: ";
-  cin >> input;
-  // Divide the whole string into substrings of size 1 and put them into the input tape.
-  for_each (input.begin(), input.end(), [&] (char c) { chars_.push_back(utils::charToString(c)); });
+  cin >> text_;
+  tokenizer.split(text_, chars_);
 }
 
 
-// Read input from tape so the head go forward
-string InTape::read () {
-  if (inx_ < chars_.size())
-      return chars_[inx_++];
-  else
-      return "";
-}
-
-// Return true if the head is not still at the end.
-bool InTape::hasNext () {
-  return inx_ < chars_.size();
-}
-
-
-// return to the first position
+// Empty the tape before loading a new input
 void InTape::reset () {
   chars_.clear();
-  inx_ = 0;
+  text_.clear();
 }
 
-string InTape::getInput() {
+string InTape::getInput(unsigned pos) const {
   string res = "";
-  for (int i = inx_; i < chars_.size();i++) {
+  for (int i = pos; i < chars_.size();i++) {
     res += chars_[i];
   }
   return res;
 }
 
 // Show the content of the input tape.
-const void InTape::show () {
+const void InTape::show () const {
   cout << "INPUT TAPE: [";
   for (int i = 0;i < chars_.size(); i++) {
     cout << chars_[i];
@@ -87,8 +70,8 @@ const void InTape::show () {
 }
 
 
-const void InTape::showInline () {
-  for (int i = inx_; i < chars_.size(); i++) {
+const void InTape::showInline (unsigned pos) const {
+  for (int i = pos; i < chars_.size(); i++) {
     cout << chars_[i];
   }
   cout << "$";
@@ -11,31 +11,35 @@
 #define _INTAPE_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "Utils.hpp"
+#include "Tokenizer.hpp"
 #include <algorithm>
 
 using namespace std;
 
-// Input tape
+// Input tape. It doesn't change once it is loaded: every configuration of the automaton keeps its
+// own read position, so the tape is never copied while the input is checked. The symbols are split by
+// the tokenizer of the input alphabet and kept as views into the text that was read.
 class InTape {
-  unsigned inx_;      // index of the actual position.
   string fileName_;   // name of the file.
-  vector<string> chars_; // Characters of the input tape.
+  string text_;       // Whole input as it was read.
+  vector<string_view> chars_; // Symbols of the input tape, into text_.
 public:
   InTape ();
-  InTape (string fileName);
+  InTape (string fileName, const Tokenizer& tokenizer);
   ~InTape ();
-  void loadFromFile (string fileName);
-  void loadFromKeyboard ();
+  void loadFromFile (string fileName, const Tokenizer& tokenizer);
+  void loadFromKeyboard (const Tokenizer& tokenizer);
   void reset ();
-  string getInput ();
-  string read ();                         // Read the actual element of the input tape so the head will move to the right (inx++)
-  string getActualChar () { return chars_[inx_]; };   // Get actual char at where the head is pointing without moving it
-  bool hasNext ();
-  const void show (); // Show the content of the input tape.
-  const void showInline ();  // show content in the trace table.
-  bool isEmpty() { return chars_.size() == 0; };
+  string getInput (unsigned pos) const;                                   // Rest of the input from the position.
+  string_view getChar (unsigned pos) const { return chars_[pos]; };      // Symbol at the position.
+  bool hasNext (unsigned pos) const { return pos < chars_.size(); };     // True if the position is not at the end.
+  unsigned getSize () const { return chars_.size(); };
+  const void show () const; // Show the content of the input tape.
+  const void showInline (unsigned pos) const;  // show content from the position in the trace table.
+  bool isEmpty() const { return chars_.size() == 0; };
 };
 
 
@@ -0,0 +1,316 @@
+#include "IncrementalChecker.hpp"
+#include "PushDownAutomaton.hpp"
+#include <algorithm>
+
+// Stale passed points and stack nodes a streamed check lets pile up before dropping them.
+const unsigned STREAM_SLACK = 1 << 16;
+
+IncrementalChecker::IncrementalChecker (const PushDownAutomaton& automaton, const RunConfig& config)
+  : automaton_(automaton), config_(config) {
+  statistics_ = NULL;
+  stream_ = NULL;
+  base_ = 0;
+  accepted_ = false;
+  stopped_ = NO_BUDGET;
+  depthCut_ = false;
+  resumed_ = 0;
+  explored_ = 0;
+  capacity_ = 0;
+
+  item_t initial;
+  initial.state = automaton_.getInitialState();
+  initial.stack = EMPTY_STACK;
+  vector<symbol_t> initialStack = automaton_.getInitialStack();
+  for (unsigned i = 0; i < initialStack.size(); i++)
+    initial.stack = stacks_.push(initial.stack, initialStack[i], automaton_.getEpsilonAnalysis().getWeight(initialStack[i]));
+
+  layer_t layer;
+  layer.begin = 0;
+  layer.cutBefore = false;
+  layer.deepRead = stacks_.getSize(initial.stack) > config_.getStackMaxDepth();
+  layer.deepClosure = false;
+  if (!layer.deepRead)
+    configurations_.push_back(initial);
+  layer.closeBegin = configurations_.size();
+  layer.closeMark = stacks_.mark();
+  layers_.push_back(layer);
+}
+
+IncrementalChecker::~IncrementalChecker () {}
+
+check_result_t IncrementalChecker::update (const vector<symbol_t>& tape) {
+  unsigned pos = mismatch(tape_.begin(), tape_.begin() + min(tape_.size(), tape.size()), tape.begin()).first - tape_.begin();
+  tape_ = tape;
+  return resume(pos);
+}
+
+check_result_t IncrementalChecker::append (const vector<symbol_t>& symbols) {
+  unsigned pos = tape_.size();
+  tape_.insert(tape_.end(), symbols.begin(), symbols.end());
+  return resume(pos);
+}
+
+check_result_t IncrementalChecker::edit (unsigned pos, unsigned erased, const vector<symbol_t>& inserted) {
+  pos = min(pos, (unsigned) tape_.size());
+  tape_.erase(tape_.begin() + pos, tape_.begin() + min(pos + erased, (unsigned) tape_.size()));
+  tape_.insert(tape_.begin() + pos, inserted.begin(), inserted.end());
+  return resume(pos);
+}
+
+// Every position is built like in resume, then the one before is dropped. The passed points are kept
+// by position of the tape, so the ones of the positions dropped are only cleared once they are many.
+// The length of the tape is not known: the stacks are cut by reading it ahead instead.
+check_result_t IncrementalChecker::stream (TapeStream& tape) {
+  stream_ = &tape;
+  explored_ = 0;
+  accepted_ = false;
+  stopped_ = NO_BUDGET;
+  deadline_ = config_.startDeadline();
+  passedPoints_.clear();
+  for (unsigned i = layers_[0].begin; i < layers_[0].closeBegin; i++)
+    passedPoints_.insert(configurations_[i].state, 0, stacks_.getFingerprint(configurations_[i].stack));
+
+  unsigned liveNodes = stacks_.getNodeCount();
+  for (base_ = 0; ; base_++) {
+    const layer_t& layer = layers_[0];
+    bool ended = !tape.hasNext(base_);
+    if (ended || layer.begin == configurations_.size()) {
+      depthCut_ = layer.cutBefore || (!ended && layer.deepRead);
+      for (unsigned j = layer.begin; ended && j < configurations_.size() && !accepted_; j++)
+        accepted_ = configurations_[j].stack == EMPTY_STACK && automaton_.isFinalState(configurations_[j].state);
+      break;
+    }
+    tape_.assign(1, tape.getSymbol(base_));
+    if (!close(0) || !read(0)) {
+      depthCut_ = layers_[0].cutBefore;
+      break;
+    }
+    dropFirst();
+    tape.release(base_ + 1);
+
+    if (passedPoints_.getSize() > 2 * configurations_.size() + STREAM_SLACK) {
+      passedPoints_.clear();
+      for (unsigned i = 0; i < configurations_.size(); i++)
+        passedPoints_.insert(configurations_[i].state, base_ + 1, stacks_.getFingerprint(configurations_[i].stack));
+    }
+    if (stacks_.getNodeCount() > 2 * liveNodes + STREAM_SLACK) {
+      vector<stack_ref> stacks (configurations_.size());
+      for (unsigned i = 0; i < stacks.size(); i++)
+        stacks[i] = configurations_[i].stack;
+      stacks_.compact(stacks);
+      for (unsigned i = 0; i < stacks.size(); i++)
+        configurations_[i].stack = stacks[i];
+      liveNodes = stacks_.getNodeCount();
+      layers_[0].closeMark = stacks_.mark();
+    }
+  }
+  stream_ = NULL;
+  return getResult();
+}
+
+// The layer of the next position takes the place of the first one.
+void IncrementalChecker::dropFirst () {
+  configurations_.erase(configurations_.begin(), configurations_.begin() + layers_[1].begin);
+  layers_.erase(layers_.begin());
+  layers_[0].begin = 0;
+  layers_[0].closeBegin = configurations_.size();
+}
+
+// The positions up to pos are kept (the e-transitions of pos are taken again), the rest are built again
+// one after the other. A position without configurations ends the check: the input can't be read there.
+check_result_t IncrementalChecker::resume (unsigned pos) {
+  if (tape_.size() > capacity_) {
+    capacity_ = tape_.size() + tape_.size() / 2;
+    pos = 0;
+  }
+  pos = min(pos, (unsigned) layers_.size() - 1);
+  truncate(pos);
+  resumed_ = pos;
+  explored_ = 0;
+  accepted_ = false;
+  stopped_ = NO_BUDGET;
+  deadline_ = config_.startDeadline();
+  passedPoints_.clear();
+  for (unsigned i = layers_[pos].begin; i < layers_[pos].closeBegin; i++)
+    passedPoints_.insert(configurations_[i].state, pos, stacks_.getFingerprint(configurations_[i].stack));
+
+  unsigned n = tape_.size();
+  for (unsigned i = pos; ; i++) {
+    const layer_t& layer = layers_[i];
+    if (i == n || layer.begin == configurations_.size()) {
+      // The configurations reached by reading the last symbol are not cut at the end of the tape, they
+      // can't move there anyway.
+      depthCut_ = layer.cutBefore || (i < n && layer.deepRead);
+      for (unsigned j = layer.begin; i == n && j < configurations_.size() && !accepted_; j++)
+        accepted_ = configurations_[j].stack == EMPTY_STACK && automaton_.isFinalState(configurations_[j].state);
+      break;
+    }
+    if (!close(i) || !read(i)) {
+      truncate(i);
+      depthCut_ = layers_[i].cutBefore;
+      break;
+    }
+  }
+  return getResult();
+}
+
+// Configurations of the positions after pos and of the e-transitions at pos are dropped, with their stacks.
+void IncrementalChecker::truncate (unsigned pos) {
+  layers_.resize(pos + 1);
+  layer_t& layer = layers_[pos];
+  configurations_.resize(layer.closeBegin);
+  stacks_.release(layer.closeMark);
+  layer.deepClosure = false;
+}
+
+// Configurations reached by e-transitions at the position, the ones that can't read its symbol are
+// skipped. They are added after the ones of the position, so the loop also goes through them.
+bool IncrementalChecker::close (unsigned pos) {
+  const layer_t& layer = layers_[pos];
+  const TransitionTable& table = automaton_.getTransitionTable();
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  bool deep = false;
+  for (unsigned i = layer.begin; i < configurations_.size(); i++) {
+    item_t item = configurations_[i];
+    if (item.stack == EMPTY_STACK)
+      continue;
+    symbol_t top = stacks_.getTop(item.stack);
+    const unsigned* begin;
+    const unsigned* end;
+    table.getRange(item.state, EPSILON, top, begin, end);
+    for (const unsigned* transition = begin; transition != end; transition++) {
+      if (analysis.isDead(*transition)) {
+        if (statistics_ != NULL)
+          statistics_->epsilonPrunes++;
+        continue;
+      }
+      if (!analysis.canStart(*transition, tape_[pos])) {
+        if (statistics_ != NULL)
+          statistics_->firstPrunes++;
+        continue;
+      }
+      if (!take(pos, item, *transition, deep))
+        return false;
+    }
+  }
+  layers_[pos].deepClosure = deep;
+  return true;
+}
+
+// Configurations of the next position, reached by reading the symbol at the position.
+bool IncrementalChecker::read (unsigned pos) {
+  layer_t next;
+  next.begin = configurations_.size();
+  next.cutBefore = layers_[pos].cutBefore || layers_[pos].deepRead || layers_[pos].deepClosure;
+  next.deepRead = false;
+  next.deepClosure = false;
+
+  const TransitionTable& table = automaton_.getTransitionTable();
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  for (unsigned i = layers_[pos].begin; i < next.begin; i++) {
+    item_t item = configurations_[i];
+    if (item.stack == EMPTY_STACK)
+      continue;
+    symbol_t top = stacks_.getTop(item.stack);
+    const unsigned* begin;
+    const unsigned* end;
+    table.getRange(item.state, tape_[pos], top, begin, end);
+    for (const unsigned* transition = begin; transition != end; transition++) {
+      if (analysis.isDead(*transition)) {
+        if (statistics_ != NULL)
+          statistics_->epsilonPrunes++;
+        continue;
+      }
+      if (!take(pos + 1, item, *transition, next.deepRead))
+        return false;
+    }
+  }
+  next.closeBegin = configurations_.size();
+  next.closeMark = stacks_.mark();
+  layers_.push_back(next);
+  if (statistics_ != NULL)
+    statistics_->maxFrontier = max(statistics_->maxFrontier, (unsigned long) (next.begin - layers_[pos].begin));
+  return true;
+}
+
+// Add the configuration reached from the item through the transition, unless it is already at the
+// position, its stack can't be emptied with the input left or it is deeper than the limit. False if a
+// budget ran out.
+bool IncrementalChecker::take (unsigned pos, const item_t& from, unsigned transition, bool& deep) {
+  if ((stopped_ = checkBudgets()) != NO_BUDGET)
+    return false;
+  if (statistics_ != NULL)
+    statistics_->fired[transition]++;
+
+  item_t item;
+  item.state = automaton_.getTargetState(transition);
+  item.stack = stacks_.pop(from.stack);
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  for (const symbol_t* symbol = automaton_.pushBegin(transition); symbol != automaton_.pushEnd(transition); symbol++)
+    item.stack = stacks_.push(item.stack, *symbol, analysis.getWeight(*symbol));
+
+  if (!fits(pos, stacks_.getWeight(item.stack))) {
+    if (statistics_ != NULL)
+      statistics_->epsilonPrunes++;
+    return true;
+  }
+  unsigned stackSize = stacks_.getSize(item.stack);
+  if (stackSize > config_.getStackMaxDepth()) {
+    deep = true;
+    if (statistics_ != NULL)
+      statistics_->depthPrunes++;
+    return true;
+  }
+  if (!passedPoints_.insert(item.state, base_ + pos, stacks_.getFingerprint(item.stack))) {
+    if (statistics_ != NULL)
+      statistics_->memoHits++;
+    return true;
+  }
+  configurations_.push_back(item);
+  if (statistics_ != NULL) {
+    statistics_->memoMisses++;
+    statistics_->expanded++;
+    statistics_->maxStackDepth = max(statistics_->maxStackDepth, stackSize);
+  }
+  return true;
+}
+
+// The stack can be emptied with the input left after the position: it is at most the capacity, or what
+// is left of a streamed tape when it is read up to the weight of the stack.
+bool IncrementalChecker::fits (unsigned pos, unsigned weight) {
+  if (stream_ == NULL)
+    return weight <= capacity_ - pos;
+  if (weight == 0 || weight > stream_->getLookahead())
+    return weight < MAX_WEIGHT;
+  return stream_->hasNext(base_ + pos + weight - 1);
+}
+
+// Budget that ran out when one more configuration is built. Like in the search, the clock is only read
+// every 1024 configurations.
+budget_t IncrementalChecker::checkBudgets () {
+  if (++explored_ > config_.getMaxConfigurations())
+    return CONFIGURATION_BUDGET;
+  if (getMemory() > config_.getMaxMemory())
+    return MEMORY_BUDGET;
+  if (explored_ % 1024 == 0 && chrono::steady_clock::now() > deadline_)
+    return TIME_BUDGET;
+  return NO_BUDGET;
+}
+
+// Bytes of everything kept between checks.
+unsigned long IncrementalChecker::getMemory () const {
+  return (unsigned long) configurations_.size() * sizeof(item_t) + layers_.size() * sizeof(layer_t) +
+         tape_.size() * sizeof(symbol_t) + (unsigned long) stacks_.getNodeCount() * sizeof(stack_node) +
+         passedPoints_.getMemory();
+}
+
+const string IncrementalChecker::getUsage () const {
+  ostringstream usage;
+  usage << "Incremental check went on from position " << resumed_ << " of " << tape_.size() << ", "
+        << explored_ << " configurations built; it keeps " << configurations_.size() << " configurations of "
+        << layers_.size() << " positions and " << stacks_.getNodeCount() << " stack nodes (~"
+        << getMemory() / 1024 << " KB)";
+  if (stopped_ != NO_BUDGET)
+    usage << ", stopped by the " << config_.describe(stopped_) << " budget";
+  return usage.str();
+}
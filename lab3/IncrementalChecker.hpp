@@ -0,0 +1,92 @@
+/***
+* @description: Check of an input that changes between checks, like the one of an editor. The live
+*               configurations of every position of the tape are kept, so after appending or editing
+*               the input the check goes on from the first position that changed instead of from the
+*               beginning, and its work depends on the positions after the edit, not on the whole input.
+*               Every live configuration is kept, so it pays off when they are few at every position; with
+*               left recursion there can be many more of them than the depth-first search ever visits.
+*               The same layers check a tape read while it arrives, keeping only the position being read.
+***/
+#ifndef _INCREMENTAL_CHECKER_HPP_
+#define _INCREMENTAL_CHECKER_HPP_
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+#include "ConfigurationMemo.hpp"
+#include "RunConfig.hpp"
+#include "SearchStatistics.hpp"
+#include "TapeStream.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+class IncrementalChecker {
+  struct item_t {
+    symbol_t state;
+    stack_ref stack;
+  };
+
+  // Configurations at one position of the tape: the ones reached by reading the symbol before it, then
+  // the ones reached from them by e-transitions. The e-transitions depend on the symbol at the position,
+  // so they are taken again when it changes; the ones reached by reading only depend on the tape before.
+  struct layer_t {
+    unsigned begin;        // First configuration of the position.
+    unsigned closeBegin;   // First configuration reached by an e-transition.
+    unsigned closeMark;    // Stack nodes created from here on belong to the e-transitions and later positions.
+    bool cutBefore;        // A branch was cut by the depth limit at an earlier position.
+    bool deepRead;         // One of the configurations reached by reading was cut by the depth limit.
+    bool deepClosure;      // One of the configurations reached by e-transitions was cut by the depth limit.
+  };
+
+  const PushDownAutomaton& automaton_;
+  const RunConfig& config_;
+  vector<symbol_t> tape_;
+  // Length of the tape the stacks are cut for: a stack needs more input to be emptied than what is left
+  // of it. It grows by half when the tape gets longer, and all the positions are checked again then.
+  unsigned capacity_;
+  search_statistics_t* statistics_;   // Counters of the check, updated when it is not NULL.
+  TapeStream* stream_;              // Tape of a streamed check, NULL otherwise.
+  unsigned long base_;              // Position of the tape the first layer is at, only a streamed check moves it.
+
+  SharedStack stacks_;              // Stacks of every configuration kept, allocated position after position.
+  vector<item_t> configurations_;   // By position, see layers_.
+  vector<layer_t> layers_;          // One for every position reached, the last one is empty if the input can't be read.
+  ConfigurationMemo passedPoints_;  // Configurations of the positions built by the actual check.
+
+  chrono::steady_clock::time_point deadline_;
+  bool accepted_;
+  budget_t stopped_;
+  bool depthCut_;
+  unsigned resumed_;                // Position the last check went on from.
+  unsigned long explored_;          // Configurations built by the last check.
+
+public:
+  IncrementalChecker (const PushDownAutomaton& automaton, const RunConfig& config);
+  ~IncrementalChecker ();
+
+  void setStatistics (search_statistics_t* statistics) { statistics_ = statistics; };
+  void reserve (unsigned length) { capacity_ = max(capacity_, length); };   // Longest tape expected, before the first check.
+  check_result_t update (const vector<symbol_t>& tape);   // Whole new input, the common beginning is kept.
+  check_result_t append (const vector<symbol_t>& symbols);
+  check_result_t edit (unsigned pos, unsigned erased, const vector<symbol_t>& inserted);
+  check_result_t stream (TapeStream& tape);   // The checker can't be updated after it.
+  check_result_t getResult () const { return makeResult(accepted_, stopped_, depthCut_); };
+  unsigned getResumed () const { return resumed_; };
+  unsigned long getExplored () const { return explored_; };
+  const string getUsage () const;
+
+private:
+  check_result_t resume (unsigned pos);
+  void truncate (unsigned pos);
+  bool close (unsigned pos);
+  bool read (unsigned pos);
+  bool take (unsigned pos, const item_t& from, unsigned transition, bool& deep);
+  bool fits (unsigned pos, unsigned weight);
+  void dropFirst ();
+  budget_t checkBudgets ();
+  unsigned long getMemory () const;
+};
+
+#endif
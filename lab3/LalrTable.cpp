@@ -0,0 +1,237 @@
+#include "LalrTable.hpp"
+#include <algorithm>
+
+
+LalrTable::LalrTable (const Grammar& grammar) : grammar_(grammar) {
+  end_ = grammar_.getTerminalCount();
+  columns_ = end_ + 1;
+  computeFirst();
+  buildStates();
+  buildActions(findLookaheads());
+}
+
+LalrTable::~LalrTable () {}
+
+void LalrTable::computeFirst () {
+  const vector<production_t>& productions = grammar_.getProductions();
+  first_.assign(grammar_.getNonterminalCount(), vector<bool>(columns_, false));
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned i = 0; i < productions.size(); i++) {
+      vector<bool>& first = first_[productions[i].lhs];
+      for (unsigned j = 0; j < productions[i].rhs.size(); j++) {
+        gsymbol_t symbol = productions[i].rhs[j];
+        if (isTerminal(symbol)) {
+          changed = changed || !first[inputOf(symbol)];
+          first[inputOf(symbol)] = true;
+          break;
+        }
+        for (unsigned c = 0; c < columns_; c++)
+          if (first_[symbol][c] && !first[c]) {
+            first[c] = true;
+            changed = true;
+          }
+        if (!grammar_.isNullable(symbol))
+          break;
+      }
+    }
+  }
+}
+
+// Items of the state with the lookaheads they get from its kernel. The items added by the closure have
+// the dot at the beginning, so they are found by their production.
+void LalrTable::closure (unsigned state, const vector<vector<bool> >& kernelLookaheads, vector<item_t>& items,
+                         vector<vector<bool> >& lookaheads) const {
+  const vector<production_t>& productions = grammar_.getProductions();
+  items = kernels_[state];
+  lookaheads = kernelLookaheads;
+  vector<int> added (productions.size(), -1);
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned i = 0; i < items.size(); i++) {
+      const vector<gsymbol_t>& rhs = productions[items[i].production].rhs;
+      if (items[i].dot == rhs.size() || isTerminal(rhs[items[i].dot]))
+        continue;
+
+      // What can follow the nonterminal after the dot.
+      vector<bool> follow (columns_, false);
+      bool nullable = true;
+      for (unsigned k = items[i].dot + 1; k < rhs.size() && nullable; k++) {
+        if (isTerminal(rhs[k])) {
+          follow[inputOf(rhs[k])] = true;
+          nullable = false;
+          continue;
+        }
+        for (unsigned c = 0; c < columns_; c++)
+          follow[c] = follow[c] || first_[rhs[k]][c];
+        nullable = grammar_.isNullable(rhs[k]);
+      }
+      if (nullable)
+        for (unsigned c = 0; c < columns_; c++)
+          follow[c] = follow[c] || lookaheads[i][c];
+
+      const vector<unsigned>& alternatives = grammar_.getProductionsOf(rhs[items[i].dot]);
+      for (unsigned j = 0; j < alternatives.size(); j++) {
+        unsigned production = alternatives[j];
+        if (added[production] < 0) {
+          added[production] = items.size();
+          items.push_back(item_t{ production, 0 });
+          lookaheads.push_back(vector<bool>(columns_, false));
+          changed = true;
+        }
+        vector<bool>& target = lookaheads[added[production]];
+        for (unsigned c = 0; c < columns_; c++)
+          if (follow[c] && !target[c]) {
+            target[c] = true;
+            changed = true;
+          }
+      }
+    }
+  }
+}
+
+// The LR(0) states, identified by their sorted kernel.
+void LalrTable::buildStates () {
+  const vector<production_t>& productions = grammar_.getProductions();
+  map<vector<unsigned long>, unsigned> states;
+  auto key = [&] (const vector<item_t>& kernel) {
+    vector<unsigned long> res;
+    for (unsigned i = 0; i < kernel.size(); i++)
+      res.push_back((unsigned long) kernel[i].production << 32 | kernel[i].dot);
+    return res;
+  };
+
+  vector<item_t> start;
+  const vector<unsigned>& starts = grammar_.getProductionsOf(grammar_.getStart());
+  for (unsigned i = 0; i < starts.size(); i++)
+    start.push_back(item_t{ starts[i], 0 });
+  kernels_.push_back(start);
+  gotos_.push_back(map<gsymbol_t, unsigned>());
+  states[key(start)] = 0;
+
+  for (unsigned s = 0; s < kernels_.size(); s++) {
+    vector<item_t> items;
+    vector<vector<bool> > lookaheads;
+    closure(s, vector<vector<bool> >(kernels_[s].size(), vector<bool>(columns_, false)), items, lookaheads);
+
+    map<gsymbol_t, vector<item_t> > next;
+    for (unsigned i = 0; i < items.size(); i++)
+      if (items[i].dot < productions[items[i].production].rhs.size())
+        next[productions[items[i].production].rhs[items[i].dot]].push_back(item_t{ items[i].production, items[i].dot + 1 });
+
+    for (auto it = next.begin(); it != next.end(); ++it) {
+      vector<item_t>& kernel = it->second;
+      sort(kernel.begin(), kernel.end(), [] (const item_t& a, const item_t& b) {
+        return a.production < b.production || (a.production == b.production && a.dot < b.dot);
+      });
+      auto found = states.find(key(kernel));
+      unsigned target;
+      if (found != states.end())
+        target = found->second;
+      else {
+        target = kernels_.size();
+        states[key(kernel)] = target;
+        kernels_.push_back(kernel);
+        gotos_.push_back(map<gsymbol_t, unsigned>());
+      }
+      gotos_[s][it->first] = target;
+    }
+  }
+}
+
+// Lookaheads of the kernel items: the end of the input for the start, then what every closure passes
+// to the kernels it goes to, until nothing changes.
+vector<vector<vector<bool> > > LalrTable::findLookaheads () const {
+  const vector<production_t>& productions = grammar_.getProductions();
+  vector<vector<vector<bool> > > res (kernels_.size());
+  for (unsigned s = 0; s < kernels_.size(); s++)
+    res[s].assign(kernels_[s].size(), vector<bool>(columns_, false));
+  for (unsigned k = 0; k < res[0].size(); k++)
+    res[0][k][end_] = true;
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (unsigned s = 0; s < kernels_.size(); s++) {
+      vector<item_t> items;
+      vector<vector<bool> > lookaheads;
+      closure(s, res[s], items, lookaheads);
+      for (unsigned i = 0; i < items.size(); i++) {
+        const vector<gsymbol_t>& rhs = productions[items[i].production].rhs;
+        if (items[i].dot == rhs.size())
+          continue;
+        unsigned target = gotos_[s].find(rhs[items[i].dot])->second;
+        const vector<item_t>& kernel = kernels_[target];
+        unsigned k = 0;
+        while (kernel[k].production != items[i].production || kernel[k].dot != items[i].dot + 1)
+          k++;
+        for (unsigned c = 0; c < columns_; c++)
+          if (lookaheads[i][c] && !res[target][k][c]) {
+            res[target][k][c] = true;
+            changed = true;
+          }
+      }
+    }
+  }
+  return res;
+}
+
+void LalrTable::buildActions (const vector<vector<vector<bool> > >& lookaheads) {
+  const vector<production_t>& productions = grammar_.getProductions();
+  unsigned nonterminals = grammar_.getNonterminalCount();
+  actions_.assign(kernels_.size() * columns_, lr_entry_t{ LR_ERROR, 0 });
+  gotoTable_.assign(kernels_.size() * nonterminals, -1);
+
+  for (unsigned s = 0; s < kernels_.size(); s++) {
+    vector<item_t> items;
+    vector<vector<bool> > itemLookaheads;
+    closure(s, lookaheads[s], items, itemLookaheads);
+    for (unsigned i = 0; i < items.size(); i++) {
+      const production_t& production = productions[items[i].production];
+      if (items[i].dot < production.rhs.size()) {
+        gsymbol_t symbol = production.rhs[items[i].dot];
+        unsigned target = gotos_[s].find(symbol)->second;
+        if (isTerminal(symbol))
+          setAction(s, inputOf(symbol), LR_SHIFT, target);
+        else
+          gotoTable_[s * nonterminals + symbol] = target;
+        continue;
+      }
+      for (unsigned c = 0; c < columns_; c++)
+        if (itemLookaheads[i][c])
+          setAction(s, c, production.lhs == grammar_.getStart() && c == end_ ? LR_ACCEPT : LR_REDUCE,
+                    items[i].production);
+    }
+  }
+}
+
+// A conflict keeps the shift, or the first production of two reductions, like yacc does.
+void LalrTable::setAction (unsigned state, unsigned column, lr_action_t action, unsigned target) {
+  lr_entry_t& entry = actions_[state * columns_ + column];
+  lr_entry_t added = { action, target };
+  if (entry.action == LR_ERROR) {
+    entry = added;
+    return;
+  }
+  if (entry.action == action && entry.target == target)
+    return;
+  string symbol = column == end_ ? "the end of the input" : grammar_.symbolName(terminalOf(column));
+  conflicts_.push_back("state " + to_string(state) + " on " + symbol + ": " + describe(entry) + " / " +
+                       describe(added));
+  if (action == LR_SHIFT || (entry.action != LR_SHIFT && target < entry.target))
+    entry = added;
+}
+
+string LalrTable::describe (const lr_entry_t& entry) const {
+  if (entry.action == LR_SHIFT)
+    return "shift to " + to_string(entry.target);
+  const production_t& production = grammar_.getProductions()[entry.target];
+  string res = (entry.action == LR_ACCEPT ? "accept " : "reduce ") + grammar_.symbolName(production.lhs) + " ->";
+  if (production.rhs.empty())
+    res += " e";
+  for (unsigned i = 0; i < production.rhs.size(); i++)
+    res += " " + grammar_.symbolName(production.rhs[i]);
+  return res;
+}
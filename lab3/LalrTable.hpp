@@ -0,0 +1,65 @@
+/***
+* @description: LALR(1) parse table of a grammar. The states are the sets of LR(0) items, and the
+*               lookaheads of their kernel items are propagated through the LR(1) closures until they
+*               don't change. A grammar with conflicts keeps the table, with the conflicts listed, but
+*               its inputs can't be decided by it.
+***/
+#ifndef _LALR_TABLE_HPP_
+#define _LALR_TABLE_HPP_
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Grammar.hpp"
+
+using namespace std;
+
+enum lr_action_t { LR_ERROR, LR_SHIFT, LR_REDUCE, LR_ACCEPT };
+
+struct lr_entry_t {
+  lr_action_t action;
+  unsigned target;   // State to shift to or production to reduce.
+};
+
+class LalrTable {
+  struct item_t {
+    unsigned production;
+    unsigned dot;
+  };
+
+  const Grammar& grammar_;
+  unsigned end_;                        // Column of the end of the input, after the input symbols.
+  unsigned columns_;
+  vector<vector<item_t> > kernels_;     // Kernel items of every state.
+  vector<map<gsymbol_t, unsigned> > gotos_;   // Transitions of every state by the symbol after the dot.
+  vector<vector<bool> > first_;         // Terminals that begin every nonterminal.
+  vector<lr_entry_t> actions_;          // By (state, input symbol or end).
+  vector<int> gotoTable_;               // By (state, nonterminal), -1 if there is none.
+  vector<string> conflicts_;
+
+public:
+  LalrTable (const Grammar& grammar);
+  ~LalrTable ();
+
+  const Grammar& getGrammar () const { return grammar_; };
+  unsigned getStateCount () const { return kernels_.size(); };
+  unsigned getEnd () const { return end_; };
+  const lr_entry_t& getAction (unsigned state, symbol_t symbol) const { return actions_[state * columns_ + symbol]; };
+  int getGoto (unsigned state, unsigned nonterminal) const {
+    return gotoTable_[state * grammar_.getNonterminalCount() + nonterminal];
+  };
+  bool hasConflicts () const { return !conflicts_.empty(); };
+  const vector<string>& getConflicts () const { return conflicts_; };
+
+private:
+  void computeFirst ();
+  void buildStates ();
+  vector<vector<vector<bool> > > findLookaheads () const;   // By state and kernel item.
+  void closure (unsigned state, const vector<vector<bool> >& kernelLookaheads, vector<item_t>& items,
+                vector<vector<bool> >& lookaheads) const;
+  void buildActions (const vector<vector<vector<bool> > >& lookaheads);
+  void setAction (unsigned state, unsigned column, lr_action_t action, unsigned target);
+  string describe (const lr_entry_t& entry) const;
+};
+
+#endif
@@ -0,0 +1,263 @@
+#include "ParallelSearch.hpp"
+#include "PushDownAutomaton.hpp"
+#include <thread>
+
+const unsigned BLOCK_BITS = 14;
+const unsigned BLOCK_SIZE = 1 << BLOCK_BITS;
+const unsigned MAX_BLOCKS = 1 << 16;
+const unsigned MEMO_SHARDS = 64;
+
+
+ConcurrentStack::ConcurrentStack () : blocks_(MAX_BLOCKS, NULL), nextBlock_(1) {
+  blocks_[0] = new stack_node[BLOCK_SIZE];
+  blocks_[0][EMPTY_STACK].symbol = NO_SYMBOL;
+  blocks_[0][EMPTY_STACK].below = EMPTY_STACK;
+  blocks_[0][EMPTY_STACK].size = 0;
+  blocks_[0][EMPTY_STACK].weight = 0;
+  blocks_[0][EMPTY_STACK].fingerprint = EMPTY_FINGERPRINT;
+}
+
+ConcurrentStack::~ConcurrentStack () {
+  for (unsigned i = 0; i < blocks_.size(); i++)
+    delete[] blocks_[i];
+}
+
+stack_ref ConcurrentStack::push (allocator_t& allocator, stack_ref stack, symbol_t symbol, unsigned weight) {
+  if (allocator.next == allocator.end) {
+    unsigned block = nextBlock_++;
+    if (block >= MAX_BLOCKS)
+      throw length_error("too many stack nodes");
+    blocks_[block] = new stack_node[BLOCK_SIZE];
+    allocator.next = block << BLOCK_BITS;
+    allocator.end = allocator.next + BLOCK_SIZE;
+  }
+
+  const stack_node& below = getNode(stack);
+  stack_node& node = blocks_[allocator.next >> BLOCK_BITS][allocator.next & (BLOCK_SIZE - 1)];
+  node.symbol = symbol;
+  node.below = stack;
+  node.size = below.size + 1;
+  node.weight = min(below.weight + weight, MAX_WEIGHT);
+  node.fingerprint = SharedStack::mix(below.fingerprint, symbol);
+  return allocator.next++;
+}
+
+const stack_node& ConcurrentStack::getNode (stack_ref stack) const {
+  return blocks_[stack >> BLOCK_BITS][stack & (BLOCK_SIZE - 1)];
+}
+
+unsigned long ConcurrentStack::getNodeCount () const {
+  return (unsigned long) min((unsigned) nextBlock_, MAX_BLOCKS) * BLOCK_SIZE;
+}
+
+ConcurrentStack::allocator_t ConcurrentStack::getFirstBlock () const {
+  allocator_t allocator;
+  allocator.next = EMPTY_STACK + 1;
+  allocator.end = BLOCK_SIZE;
+  return allocator;
+}
+
+
+ParallelSearch::ParallelSearch (const PushDownAutomaton& automaton, const RunConfig& config)
+  : automaton_(automaton), threads_(max(config.getThreads(), 1u)), config_(config),
+    memo_(MEMO_SHARDS), memoLocks_(MEMO_SHARDS), workers_(threads_),
+    stop_(false), accepted_(false), stopped_(NO_BUDGET), depthCut_(false), pending_(0), configurations_(0) {
+  tape_ = NULL;
+
+  for (unsigned i = 0; i < workers_.size(); i++) {
+    workers_[i].allocator.next = workers_[i].allocator.end = 0;
+    workers_[i].steals = 0;
+  }
+}
+
+ParallelSearch::~ParallelSearch () {}
+
+bool ParallelSearch::run (symbol_t state, vector<symbol_t> initialStack, const vector<symbol_t>& tape) {
+  tape_ = &tape;
+  deadline_ = config_.startDeadline();
+  task_t initial;
+  initial.state = state;
+  initial.pos = 0;
+  initial.stack = EMPTY_STACK;
+  ConcurrentStack::allocator_t allocator = stacks_.getFirstBlock();
+  for (unsigned i = 0; i < initialStack.size(); i++)
+    initial.stack = stacks_.push(allocator, initial.stack, initialStack[i],
+                                 automaton_.getEpsilonAnalysis().getWeight(initialStack[i]));
+
+  insertPassedPoint(initial);
+  configurations_++;
+  pending_++;
+  workers_[0].tasks.push_back(initial);
+
+  vector<thread> pool;
+  for (unsigned i = 1; i < threads_; i++)
+    pool.push_back(thread(&ParallelSearch::work, this, i));
+  work(0);
+  for (unsigned i = 0; i < pool.size(); i++)
+    pool[i].join();
+
+  return accepted_;
+}
+
+// Expand the own configurations depth-first, steal from the other workers when there are none left.
+void ParallelSearch::work (unsigned id) {
+  worker_t& worker = workers_[id];
+  task_t task;
+  while (!stop_) {
+    if (pop(worker, task) || steal(id, task)) {
+      expand(worker, task);
+      pending_--;
+    }
+    else if (pending_ == 0)
+      break;
+    else
+      this_thread::yield();
+  }
+}
+
+// Same steps as Search::enterConfiguration (acceptance, the cut by the input needed to empty the stack,
+// then the depth limit) followed by the expansion of every transition, skipping the dead ones and the
+// e-transitions that can't read the next symbol like Search::nextTransition.
+void ParallelSearch::expand (worker_t& worker, const task_t& task) {
+  const vector<symbol_t>& tape = *tape_;
+  const stack_node& top = stacks_.getNode(task.stack);
+  bool hasNext = task.pos < tape.size();
+  if (!hasNext && !top.size) {
+    if (automaton_.isFinalState(task.state)) {
+      accepted_ = true;
+      stop_ = true;
+    }
+    return;
+  } else if (!hasNext || !top.size)
+    return;
+  if (top.weight > tape.size() - task.pos)
+    return;   // The stack needs more input than what is left.
+  if (top.size > config_.getStackMaxDepth()) {
+    depthCut_ = true;
+    return;
+  }
+
+  const TransitionTable& table = automaton_.getTransitionTable();
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  const unsigned* read;
+  const unsigned* readEnd;
+  const unsigned* empty;
+  const unsigned* emptyEnd;
+  table.getRange(task.state, tape[task.pos], top.symbol, read, readEnd);
+  table.getRange(task.state, EPSILON, top.symbol, empty, emptyEnd);
+
+  task_t children[64];
+  vector<task_t> more;
+  unsigned count = 0;
+  while ((read != readEnd || empty != emptyEnd) && !stop_) {
+    unsigned transition;
+    if (empty == emptyEnd || (read != readEnd && *read < *empty))
+      transition = *read++;
+    else
+      transition = *empty++;
+    if (analysis.isDead(transition) || !analysis.canStart(transition, tape[task.pos]))
+      continue;
+
+    task_t child;
+    child.state = automaton_.getTargetState(transition);
+    child.pos = task.pos + (automaton_.getTransitions()[transition].input != EPSILON ? 1 : 0);
+    child.stack = top.below;
+    for (const symbol_t* symbol = automaton_.pushBegin(transition); symbol != automaton_.pushEnd(transition); symbol++)
+      child.stack = stacks_.push(worker.allocator, child.stack, *symbol, analysis.getWeight(*symbol));
+
+    if (!insertPassedPoint(child))
+      continue;
+    budget_t budget = checkBudgets(++configurations_);
+    if (budget != NO_BUDGET) {
+      stop(budget);
+      return;
+    }
+    if (count < 64)
+      children[count++] = child;
+    else
+      more.push_back(child);
+  }
+
+  // Pushed in reverse so the first transition of the file is expanded first.
+  pending_ += count + more.size();
+  lock_guard<mutex> guard(worker.lock);
+  for (unsigned i = more.size(); i > 0; i--)
+    worker.tasks.push_back(more[i - 1]);
+  for (unsigned i = count; i > 0; i--)
+    worker.tasks.push_back(children[i - 1]);
+}
+
+bool ParallelSearch::pop (worker_t& worker, task_t& task) {
+  lock_guard<mutex> guard(worker.lock);
+  if (worker.tasks.empty())
+    return false;
+  task = worker.tasks.back();
+  worker.tasks.pop_back();
+  return true;
+}
+
+// Take the oldest configuration of another worker: it is the one closest to the root, so the biggest piece of work.
+bool ParallelSearch::steal (unsigned thief, task_t& task) {
+  for (unsigned i = 1; i < workers_.size(); i++) {
+    worker_t& victim = workers_[(thief + i) % workers_.size()];
+    lock_guard<mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      workers_[thief].steals++;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ParallelSearch::insertPassedPoint (const task_t& task) {
+  fingerprint_t fingerprint = stacks_.getNode(task.stack).fingerprint;
+  unsigned shard = ((fingerprint ^ (task.pos * 0x9E3779B97F4A7C15ULL) ^ task.state) >> 32) % MEMO_SHARDS;
+  lock_guard<mutex> guard(memoLocks_[shard]);
+  return memo_[shard].insert(task.state, task.pos, fingerprint);
+}
+
+// The memory is estimated from the stack blocks taken and the passed points, the clock is read every 1024 configurations.
+budget_t ParallelSearch::checkBudgets (unsigned long explored) const {
+  if (explored > config_.getMaxConfigurations())
+    return CONFIGURATION_BUDGET;
+  if (explored % 1024 == 0) {
+    unsigned long memory = stacks_.getNodeCount() * sizeof(stack_node) + explored * ConfigurationMemo::getEntryMemory();
+    if (memory > config_.getMaxMemory())
+      return MEMORY_BUDGET;
+    if (chrono::steady_clock::now() > deadline_)
+      return TIME_BUDGET;
+  }
+  return NO_BUDGET;
+}
+
+// The first budget that runs out is the one reported.
+void ParallelSearch::stop (budget_t budget) {
+  int none = NO_BUDGET;
+  stopped_.compare_exchange_strong(none, budget);
+  stop_ = true;
+}
+
+unsigned long ParallelSearch::getPassedPoints () const {
+  unsigned long total = 0;
+  for (unsigned i = 0; i < memo_.size(); i++)
+    total += memo_[i].getSize();
+  return total;
+}
+
+const string ParallelSearch::getUsage () const {
+  string usage = "Parallel search with " + to_string(threads_) + " threads explored " + to_string(getConfigurations()) +
+                 " configurations, " + to_string(getStackNodes()) + " stack nodes reserved, " +
+                 to_string(getSteals()) + " steals";
+  if (stopped_ != NO_BUDGET)
+    usage += ", stopped by the " + config_.describe((budget_t) stopped_.load()) + " budget";
+  return usage;
+}
+
+unsigned long ParallelSearch::getSteals () const {
+  unsigned long total = 0;
+  for (unsigned i = 0; i < workers_.size(); i++)
+    total += workers_[i].steals;
+  return total;
+}
@@ -0,0 +1,99 @@
+/***
+* @description: Parallel search of the pushdown automaton. Sibling branches are spread over a pool of
+*               workers that steal configurations from each other, all of them share the passed points,
+*               and the first worker that accepts the input stops the others.
+***/
+#ifndef _PARALLEL_SEARCH_HPP_
+#define _PARALLEL_SEARCH_HPP_
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <string>
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+#include "ConfigurationMemo.hpp"
+#include "RunConfig.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+// Configuration waiting in the deque of a worker.
+struct task_t {
+  symbol_t state;
+  unsigned pos;
+  stack_ref stack;
+};
+
+// Shared stack that several workers can push to at the same time. Nodes are stored in blocks that never
+// move, every worker takes whole blocks for itself so pushing doesn't need locks.
+class ConcurrentStack {
+  vector<stack_node*> blocks_;
+  atomic<unsigned> nextBlock_;
+
+public:
+  struct allocator_t {   // Free nodes of the block a worker is filling.
+    stack_ref next;
+    stack_ref end;
+  };
+
+  ConcurrentStack ();
+  ~ConcurrentStack ();
+
+  stack_ref push (allocator_t& allocator, stack_ref stack, symbol_t symbol, unsigned weight = 0);
+  const stack_node& getNode (stack_ref stack) const;
+  unsigned long getNodeCount () const;
+  allocator_t getFirstBlock () const;   // Rest of the block of the empty stack, for the initial configuration.
+};
+
+class ParallelSearch {
+  struct worker_t {
+    deque<task_t> tasks;   // The owner works on the back (depth-first), thieves take from the front.
+    mutex lock;
+    ConcurrentStack::allocator_t allocator;
+    unsigned long steals;
+  };
+
+  const PushDownAutomaton& automaton_;
+  const vector<symbol_t>* tape_;
+  unsigned threads_;
+  const RunConfig& config_;
+  chrono::steady_clock::time_point deadline_;
+
+  ConcurrentStack stacks_;
+  vector<ConfigurationMemo> memo_;   // Passed points split in shards, every one with its lock.
+  vector<mutex> memoLocks_;
+  deque<worker_t> workers_;
+
+  atomic<bool> stop_;
+  atomic<bool> accepted_;
+  atomic<int> stopped_;             // budget_t that stopped the search.
+  atomic<bool> depthCut_;
+  atomic<long> pending_;            // Tasks pushed but not expanded yet.
+  atomic<unsigned long> configurations_;
+
+public:
+  ParallelSearch (const PushDownAutomaton& automaton, const RunConfig& config);
+  ~ParallelSearch ();
+
+  bool run (symbol_t state, vector<symbol_t> initialStack, const vector<symbol_t>& tape);
+
+  check_result_t getResult () const { return makeResult(accepted_, (budget_t) stopped_.load(), depthCut_); };
+  unsigned long getConfigurations () const { return configurations_; };
+  unsigned long getStackNodes () const { return stacks_.getNodeCount(); };
+  unsigned long getPassedPoints () const;
+  unsigned long getSteals () const;
+  const string getUsage () const;
+
+private:
+  void work (unsigned id);
+  void expand (worker_t& worker, const task_t& task);
+  bool pop (worker_t& worker, task_t& task);
+  bool steal (unsigned thief, task_t& task);
+  bool insertPassedPoint (const task_t& task);
+  budget_t checkBudgets (unsigned long explored) const;
+  void stop (budget_t budget);
+};
+
+#endif
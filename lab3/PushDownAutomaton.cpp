@@ -2,6 +2,7 @@
 #include "Stack.hpp"
 #include <algorithm>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -12,30 +13,51 @@
 
 PushDownAutomaton::PushDownAutomaton (string fileName) {
   inputTape_ = new InTape();
+  initSettings();
   loadAutomaton(fileName);
 }
 
 PushDownAutomaton::PushDownAutomaton (string automatonFile, string inputFile) {
   inputTape_ = new InTape();
+  initSettings();
   loadAutomaton(automatonFile);
   loadInput(inputFile);
 }
 
+PushDownAutomaton::~PushDownAutomaton () {
+  delete stack_;
+  delete inputTape_;
+  delete grammar_;
+  delete lalr_;
+  delete image_;
+  delete incremental_;
+}
+
 // Initialization methods
 void PushDownAutomaton::loadInput (string fileName) {
-  inputTape_->loadFromFile(fileName);
+  inputTape_->loadFromFile(fileName, Tokenizer (inputIds_, inputIds_.size()));
 }
 
 
 void PushDownAutomaton::loadInputByKeyboard () {
-    inputTape_->loadFromKeyboard();
+    inputTape_->loadFromKeyboard(Tokenizer (inputIds_, inputIds_.size()));
 }
 
 void PushDownAutomaton::loadAutomaton (string fileName) {
+  if (AutomatonImage::isImage(fileName)) {
+    loadImage(fileName);
+    return;
+  }
+  if (Grammar::isGrammarFile(fileName)) {
+    loadGrammar(fileName);
+    return;
+  }
   ifstream file;
   file.open(fileName.c_str());
   if (file.is_open()) {
       string temp;
+      inputIds_.intern("e");  // EPSILON
+
       getline (file, temp);
       readStates (temp);
       getline (file, temp);
@@ -53,202 +75,303 @@ void PushDownAutomaton::loadAutomaton (string fileName) {
         saveTransition (temp);
       }
       file.close();
+      buildTransitionTable();
+      loaded_ = true;
   }
   else {
     cerr << "El fichero no existe" << endl;
   }
 }
 
+bool PushDownAutomaton::compile (string fileName) const {
+  return AutomatonImage::write(*this, fileName);
+}
+
 
 // Execution methods
-bool PushDownAutomaton::checkInput (bool trace) {
-  transactionHistory = vector<string>(0);
-  passedPoints.clear();
+static double getSeconds (chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+check_result_t PushDownAutomaton::checkInput (bool trace) {
+  usage_ = "";
+  search_statistics_t* statistics = NULL;
+  if (config_.hasStatistics()) {
+    statistics = &statistics_;
+    resetStatistics(statistics_, transitions_.size());
+  }
   if (!inputTape_->isEmpty()) {
-    acceptedInput_ = false;
-    if (trace)
-      cout << "---- State ---- ---- Input ---- ---- Stack ---- ---- Actions ----" << endl;
-      nextStep (actualState_, *inputTape_, *stack_, 0, trace);
-      return acceptedInput_;
+    vector<symbol_t> tape = readTape(*inputTape_);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    try {
+      if (engine_ == EARLEY_ENGINE) {
+        // The grammar accepts the same inputs as the search, but it has no stack depth limit.
+        if (trace)
+          cout << "The trace is only shown by the search engine." << endl;
+        EarleyRecognizer recognizer (*grammar_, config_);
+        recognizer.recognize(tape);
+        statistics_.seconds = getSeconds(start);
+        result_ = recognizer.getResult();
+        usage_ = "Earley parser built " + to_string(recognizer.getItemCount()) + " items";
+        statistics_.expanded = recognizer.getItemCount();
+      }
+      else if (config_.isIncremental() && !trace) {
+        // Only the positions from the first symbol that changed since the last check are checked again.
+        if (incremental_ == NULL)
+          incremental_ = new IncrementalChecker(*this, config_);
+        incremental_->setStatistics(statistics);
+        incremental_->update(tape);
+        statistics_.seconds = getSeconds(start);
+        result_ = incremental_->getResult();
+        usage_ = incremental_->getUsage();
+      }
+      else if (hasParser() && !trace) {
+        // The automaton of the grammar leaves out the nullable symbols it ends with, so it agrees with the parser.
+        ShiftReduceParser parser (*lalr_, config_);
+        parser.setStatistics(statistics);
+        parser.run(tape);
+        statistics_.seconds = getSeconds(start);
+        result_ = parser.getResult();
+        usage_ = "Shift-reduce parse: " + to_string(parser.getMoves()) + " moves, stack depth up to " +
+                 to_string(parser.getMaxDepth());
+      }
+      else if (deterministic_ && !trace) {
+        // A deterministic automaton has a single path to follow, trace mode still shows it with the search.
+        DeterministicRunner runner (*this, config_);
+        runner.setStatistics(statistics);
+        runner.run(tape);
+        statistics_.seconds = getSeconds(start);
+        result_ = runner.getResult();
+        usage_ = "Deterministic run: " + to_string(runner.getMoves()) + " moves, stack depth up to " +
+                 to_string(runner.getMaxDepth());
+      }
+      else if (config_.getThreads() > 1 && !trace) {
+        // Sibling branches are spread over the threads. The derivation is not printed: workers don't keep it.
+        ParallelSearch search (*this, config_);
+        search.run(actualState_, getInitialStack(), tape);
+        statistics_.seconds = getSeconds(start);
+        result_ = search.getResult();
+        usage_ = search.getUsage();
+        statistics_.expanded = search.getConfigurations();
+      }
+      else {
+        // The trace is recorded while searching and rendered once the search ends.
+        TraceSink* sink = trace ? new TraceSink(config_.getTraceFile()) : NULL;
+        Search search (*this, tape, search_, config_);
+        search.setTrace(sink);
+        search.setStatistics(statistics);
+        search.setInput(inputTape_);
+        search.run();
+        statistics_.seconds = getSeconds(start);
+        result_ = search.getResult();
+        usage_ = search.getUsage();
+        if (sink != NULL) {
+          sink->flush();
+          showTrace(*sink);
+          delete sink;
+        }
+        search.showDerivation();
+      }
+    }
+    catch (exception& e) {
+      // The engines only throw when they can't get more memory.
+      cout << e.what() << '\n';
+      result_ = makeResult(false, MEMORY_BUDGET, false);
+    }
+    return result_;
   }
   else {
     cout << endl << "You have to load input first." << endl;
-    return false;
+    return makeResult(false, NO_BUDGET, false);
   }
 }
 
-vector<string> split(string& s, string& delimiter) {
-    vector<std::string> tokens;
-    size_t pos = 0;
-    string token;
-    while ((pos = s.find(delimiter)) != string::npos) {
-        token = s.substr(0, pos);
-        tokens.push_back(token);
-        s.erase(0, pos + delimiter.length());
-    }
-    tokens.push_back(s);
+// Same engines as checkInput, but nothing is printed and nothing of the automaton is changed.
+check_result_t PushDownAutomaton::checkTape (const vector<symbol_t>& tape) const {
+  if (engine_ == EARLEY_ENGINE) {
+    EarleyRecognizer recognizer (*grammar_, config_);
+    recognizer.recognize(tape);
+    return recognizer.getResult();
+  }
+  if (hasParser()) {
+    ShiftReduceParser parser (*lalr_, config_);
+    parser.run(tape);
+    return parser.getResult();
+  }
+  if (deterministic_) {
+    DeterministicRunner runner (*this, config_);
+    runner.run(tape);
+    return runner.getResult();
+  }
+  Search search (*this, tape, search_, config_);
+  search.setVerbose(false);
+  search.run();
+  return search.getResult();
+}
 
-    return tokens;
+// The shift-reduce parser and a deterministic automaton run online, keeping the symbol being read. The
+// other automata are checked by the layers of the incremental checker, which only keep the configurations
+// of the position being read and the symbols read ahead to cut their stacks. The engine is always the
+// automaton: the Earley parser goes back to the items of every position.
+check_result_t PushDownAutomaton::checkStream (TapeStream& tape) {
+  if (hasParser()) {
+    ShiftReduceParser parser (*lalr_, config_);
+    parser.run(tape);
+    usage_ = "Shift-reduce parse: " + to_string(parser.getMoves()) + " moves, stack depth up to " +
+             to_string(parser.getMaxDepth()) + ", " + to_string(tape.getRead()) + " symbols read and up to " +
+             to_string(tape.getPeakWindow()) + " kept";
+    return parser.getResult();
+  }
+  if (deterministic_) {
+    DeterministicRunner runner (*this, config_);
+    runner.run(tape);
+    usage_ = "Deterministic run: " + to_string(runner.getMoves()) + " moves, stack depth up to " +
+             to_string(runner.getMaxDepth()) + ", " + to_string(tape.getRead()) + " symbols read and up to " +
+             to_string(tape.getPeakWindow()) + " kept";
+    return runner.getResult();
+  }
+  IncrementalChecker checker (*this, config_);
+  check_result_t result = checker.stream(tape);
+  usage_ = "Layered check: " + to_string(checker.getExplored()) + " configurations built, " +
+           to_string(tape.getRead()) + " symbols read and up to " + to_string(tape.getPeakWindow()) + " kept";
+  return result;
 }
 
-string parseConfiguration(Stack stack, string state, string input) {
-  return "(" + state + "," +
-         input + "," +
-         stack.getStackLine() + ")";
+// The layers of a position take every e-transition, so the ones that grow the stack without reading
+// would only be cut by reading the whole input ahead. They need a depth limit.
+bool PushDownAutomaton::canStream () const {
+  return hasParser() || deterministic_ || config_.hasStackMaxDepth() ||
+         (epsilon_.isComplete() && epsilon_.getGrowingCount() == 0);
 }
 
-void printConfiguration(vector<string> transitions) {
-  cout << "Configuration: ";
-  for (auto i : transitions) {
-      cout << i << " |- ";
+// The tape is read through its symbol ids, an "e" on the tape can only be followed by e-transitions.
+vector<symbol_t> PushDownAutomaton::readTape (const InTape& input) const {
+  vector<symbol_t> tape (input.getSize());
+  for (unsigned i = 0; i < tape.size(); i++) {
+    tape[i] = inputIds_.find(string(input.getChar(i)));
+    if (tape[i] == EPSILON)
+      tape[i] = NO_SYMBOL;
   }
-  cout << endl;
+  return tape;
 }
 
-void PushDownAutomaton::nextStep (string actualState, InTape input, Stack stack, int readCount, bool trace) {
-  if (!acceptedInput_) {
-    try {
-        if (!input.hasNext() && !stack.getSize()) {
-          if (isFinalState(actualState)) {
-            printConfiguration(transactionHistory);
-            acceptedInput_ = true;
-          }
-        } else if (!input.hasNext() || !stack.getSize())
-          return;
-
-        vector<transition_t> allowedTransitions = getAllowedTransitionsForState (actualState, input, stack);
-
-        if (trace)
-          showActualTraceInfo (actualState, input, stack, allowedTransitions);
-
-        if (stack.getSize() > stoi(getenv("STACK_MAX_DEPTH"))) {
-          printConfiguration(transactionHistory);
-          cout << "End limit" << endl;
-          return;
-        }
-
-        passedPoints[stack.getStackLine()+input.getInput()] = stack.getStackLine().length();
-
-
-        for (int i = 0; i < allowedTransitions.size(); i++) {
-          Stack tempStack = stack;
-          InTape tempInput = input;
-          string actual = allowedTransitions[i].first;
-          string next = allowedTransitions[i].second;
-
-          istringstream iss(actual);
-
-          string readInput;
-          iss >> readInput;  // Actual state
-          iss >> readInput;  // actual input to read
-          if (readInput != "e") {
-            readInput = tempInput.read();
-          }
-          else {
-            readInput = "e";  // We don't consume the input
-          }
-
-          istringstream iss2(next);
-          string nextState;
-          vector<string> nextStackSymbols;
-          iss2 >> nextState;
-
-          // it can push more than one symbol.
-          string symbols;
-          iss2 >> symbols;
-
-          tempStack.pop();
-          for (int i = symbols.size() - 1; i >= 0; i--) {
-            string symbol = utils::charToString(symbols[i]);
-            if (symbol != "e")
-              tempStack.push (symbol);
-          }
-
-          string configuration = parseConfiguration(tempStack, actualState, tempInput.getInput());
-          transactionHistory.push_back(configuration);
-
-          if (passedPoints[tempStack.getStackLine()+tempInput.getInput()] >= stack.getStackLine().length()) {
-            printConfiguration(transactionHistory);
-            cout << "Loop detected, " << tempStack.getStackLine() <<
-                 ", " << tempInput.getInput() << " skip" << endl;
-            transactionHistory.pop_back();  
-            return;
-          }
-
-          nextStep (nextState, tempInput, tempStack, readCount + 1, trace);
-          transactionHistory.pop_back();
-        }
-    }
-    catch (exception& e) {
-      cout << e.what() << '\n';
-    }
+void PushDownAutomaton::setEngine (engine_t engine) {
+  engine_ = engine;
+  if (engine_ == EARLEY_ENGINE && grammar_ == NULL) {
+    grammar_ = new Grammar (*this);
+    cout << "Grammar of the automaton: " << grammar_->getNonterminalCount() << " nonterminals, "
+         << grammar_->getProductions().size() << " productions" << endl;
   }
 }
 
+// State and symbols to push of a transition, the symbols are given in push order and the ones out of
+// the stack alphabet are left out.
+void PushDownAutomaton::readTarget (unsigned transition, symbol_t& state, vector<symbol_t>& symbols) const {
+  state = getTargetState(transition);
+  symbols.assign(pushBegin(transition), pushEnd(transition));
+}
 
-vector<transition_t> PushDownAutomaton::getAllowedTransitionsForState (string actualState, InTape input, Stack stack) {
-  string actual = actualState + " " + input.read() + " " + stack.getTop();
-  string actualEmpty = actualState + " e " + stack.getTop(); // This transition is used to check e-transitions
+vector<symbol_t> PushDownAutomaton::getInitialStack () const {
+  vector<symbol_t> initialStack;
+  if (stack_->getSize() > 0)
+    initialStack.push_back(stack_->getInitialSymbol());
+  return initialStack;
+}
 
-  vector<transition_t> allowed;
-  for (int i = 0;i < transitions_.size(); i++)
-    if (transitions_[i].first == actual || transitions_[i].first == actualEmpty)
-      allowed.push_back(transitions_[i]);
+vector<string> PushDownAutomaton::getDefinition () const {
+  auto join = [] (const vector<string>& names) {
+    string line;
+    for (unsigned i = 0; i < names.size(); i++)
+      line += (i > 0 ? " " : "") + names[i];
+    return line;
+  };
+  vector<string> lines;
+  lines.push_back(join(states_));
+  lines.push_back(join(inputSymbols_));
+  lines.push_back(join(stack_->getAcceptedSymbols()));
+  lines.push_back(initialState_);
+  lines.push_back(stack_->getInitialSymbolName());
+  lines.push_back(finalStates_[0] != "NO_FINAL" ? join(finalStates_) : "");
+  return lines;
+}
 
-  return allowed;
+// What the last check did: memory kept by the search or work done by the other engines.
+void PushDownAutomaton::showSearchUsage () {
+  if (usage_ != "")
+    cout << usage_ << endl;
 }
 
-void PushDownAutomaton::showActualTraceInfo (string actualState, InTape input, Stack stack, vector<transition_t> allowedTransitions) {
-  cout << setw(8) << actualState << setw(14);
-  input.showInline();
-  cout << setw(14);
-  stack.showInline();
-  cout << setw(14);
-  if (allowedTransitions.size() > 0)
-    showAllowedTransitions (allowedTransitions);
-  else {
-    cout << "         NO TRANSITIONS ALLOWED.." << endl;
-    if (!acceptedInput_) {
-      cout << "STRING IS NOT PASSED CURRENT PATH.." << endl;
-    } else {
-      cout << "STRING IS SUCCESSFULLY PASSED.." << endl;
-    }
-    cout << "==========================================================================" << endl;
-  }
+// The parallel search and the Earley parser only count what they expanded.
+void PushDownAutomaton::showStatistics () {
+  ::showStatistics(cout, statistics_, transitions_);
 }
 
-void PushDownAutomaton::showAllowedTransitions (vector<transition_t> transitions) {
-  for (int i = 0; i < transitions.size(); i++) {
-    cout << transitions[i].second;
-    if (i < transitions.size() - 1)
-      cout << ", ";
+
+void PushDownAutomaton::showTrace (const TraceSink& sink) {
+  if (!sink.isOpen()) {
+    cerr << "The trace file can't be written: " << sink.getFileName() << endl;
+    return;
   }
-  cout << endl;
+  if (!sink.isInMemory()) {
+    cout << "Trace of " << sink.getRecorded() << " records written to " << sink.getFileName() << endl;
+    return;
+  }
+  TraceFormatter formatter;
+  if (formatter.load(sink))
+    formatter.showTable(cout);
 }
 
-
 bool PushDownAutomaton::isFinalState (string state) {
   return any_of(finalStates_.begin(), finalStates_.end(), [&state](string finalState) { return state == finalState; });
 }
 
+bool PushDownAutomaton::isFinalState (symbol_t state) const {
+  return state < finalStateIds_.size() && finalStateIds_[state];
+}
 
 // Private methods
+void PushDownAutomaton::initSettings () {
+  search_ = DEPTH_FIRST;
+  result_ = makeResult(false, NO_BUDGET, false);
+  resetStatistics(statistics_, 0);
+  engine_ = SEARCH_ENGINE;
+  grammar_ = NULL;
+  lalr_ = NULL;
+  stack_ = NULL;
+  targetStatesData_ = NULL;
+  pushStartData_ = NULL;
+  pushSymbolsData_ = NULL;
+  pushStart_.assign(1, 0);
+  image_ = NULL;
+  incremental_ = NULL;
+  loaded_ = false;
+}
+
 void PushDownAutomaton::readStates (string states) {
   states_ = utils::lineToStrings (states, " ");
+  for (int i = 0; i < states_.size(); i++)
+    stateIds_.intern(states_[i]);
 }
 
 
 void PushDownAutomaton::readInputSymbols (string symbols) {
   inputSymbols_ = utils::lineToStrings (symbols, " ");
+  for (int i = 0; i < inputSymbols_.size(); i++)
+    inputIds_.intern(inputSymbols_[i]);
 }
 
 void PushDownAutomaton::readStackSymbols (string symbols) {
-  stack_ = new Stack (utils::lineToStrings (symbols, " "));
+  vector<string> stackSymbols = utils::lineToStrings (symbols, " ");
+  for (int i = 0; i < stackSymbols.size(); i++)
+    stackIds_.intern(stackSymbols[i]);
+  stackAlphabetSize_ = stackIds_.size();
+  stack_ = new Stack (stackIds_, stackAlphabetSize_);
 }
 
 void PushDownAutomaton::readInitialState (string state) {
   initialState_ = state;
-  actualState_ = initialState_;
+  actualState_ = stateIds_.intern(initialState_);
 }
 
 void PushDownAutomaton::readInitialStackSymbol (string symbol) {
@@ -262,43 +385,197 @@ void PushDownAutomaton::readFinalStates (string states) {
     finalStates_.push_back("NO_FINAL");
 }
 
+// The text is kept to show it, the key is interned and the target is tokenized once: the symbols to push
+// are split by the stack alphabet, so they can have more than one character ("q0 e E q0 Expr + Term").
 void PushDownAutomaton::saveTransition (string transition) {
-  //transitions_.push_back(transition);
-  string actual = "";
-  string next = "";
-  istringstream iss(transition);
-
-  string temp;
-  iss >> temp;  // Actual state
-  if (temp.size() > 1) {
-    actual += temp;
-    actual += " ";
-    iss >> temp;  // actual input character
-    actual += temp;
-    actual += " ";
-    iss >> temp;  // actual stack symbol
-    actual += temp;
-
-    iss >> temp;    // next state
-    next += temp;
-    next += " ";
-    while (!iss.eof()) {
-      iss >> temp;    // next symbol to push to stack
-      next += temp ;
-    }
+  vector<string> words = utils::lineToStrings(transition, " \t\r");
+  if (words.size() < 4 || words[0].size() <= 1)
+    return;
+
+  transition_t trans;
+  trans.actual = words[0] + " " + words[1] + " " + words[2];
+  string push;
+  for (unsigned i = 4; i < words.size(); i++)
+    push += (i > 4 ? " " : "") + words[i];
+  trans.next = words[3] + " " + push;
+  trans.state = stateIds_.intern(words[0]);
+  trans.input = inputIds_.intern(words[1]);
+  trans.top = stackIds_.intern(words[2]);
+  transitions_.push_back(trans);
+  targetStates_.push_back(stateIds_.intern(words[3]));
+
+  // The first symbol written is the new top, so they are pushed from the last one.
+  vector<string_view> tokens;
+  Tokenizer (stackIds_, stackAlphabetSize_).split(push, tokens);
+  for (unsigned i = tokens.size(); i > 0; i--) {
+    symbol_t id = stackIds_.find(string(tokens[i - 1]));
+    if (id < stackAlphabetSize_)
+      pushSymbols_.push_back(id);
+    else if (tokens[i - 1] != "e")
+      cerr << "The symbol " << tokens[i - 1] << " is not contained in the stack alphabet" << endl;
+  }
+  pushStart_.push_back(pushSymbols_.size());
+}
+
+// Called once every transition is read.
+void PushDownAutomaton::buildTransitionTable () {
+  table_.build(transitions_);
+  targetStatesData_ = targetStates_.data();
+  pushStartData_ = pushStart_.data();
+  pushSymbolsData_ = pushSymbols_.data();
 
-    transition_t trans;
-    trans.first = actual;
-    trans.second = next;
-    transitions_.push_back(trans);
+  deterministic_ = checkDeterminism();
+  indexFinalStates();
+  epsilon_.analyse(*this);
+}
+
+// The definition lines are read like the ones of a text file, everything else is used from the image:
+// the transition table points into the mapping, the targets are read from it and the analysis of the
+// e-transitions is copied from it.
+void PushDownAutomaton::loadImage (string fileName) {
+  image_ = new AutomatonImage();
+  if (!image_->open(fileName)) {
+    cerr << "The automaton image can't be used: " << fileName << endl;
+    delete image_;
+    image_ = NULL;
+    return;
+  }
+  const image_header_t& header = image_->getHeader();
+
+  inputIds_.intern("e");  // EPSILON
+  readStates(image_->getString(DEFINITION_SECTION, 0));
+  readInputSymbols(image_->getString(DEFINITION_SECTION, 1));
+  readStackSymbols(image_->getString(DEFINITION_SECTION, 2));
+  readInitialState(image_->getString(DEFINITION_SECTION, 3));
+  readInitialStackSymbol(image_->getString(DEFINITION_SECTION, 4));
+  readFinalStates(image_->getString(DEFINITION_SECTION, 5));
+
+  // The names left (the ones only used by transitions) must get the ids the image gave them.
+  if (stackAlphabetSize_ != header.stackAlphabetSize || !readImageNames(stateIds_, STATE_NAMES_SECTION, header.states) ||
+      !readImageNames(inputIds_, INPUT_NAMES_SECTION, header.inputs) ||
+      !readImageNames(stackIds_, STACK_NAMES_SECTION, header.stackSymbols)) {
+    cerr << "The automaton image doesn't match its definition: " << fileName << endl;
+    delete image_;
+    image_ = NULL;
+    return;
+  }
+
+  const unsigned* keys = image_->getSection(KEYS_SECTION);
+  transitions_.resize(header.transitions);
+  for (unsigned i = 0; i < header.transitions; i++) {
+    transitions_[i].actual = image_->getString(TEXT_SECTION, 2 * i);
+    transitions_[i].next = image_->getString(TEXT_SECTION, 2 * i + 1);
+    transitions_[i].state = keys[3 * i];
+    transitions_[i].input = keys[3 * i + 1];
+    transitions_[i].top = keys[3 * i + 2];
+  }
+  table_.attach((const cell_slot_t*) image_->getSection(CELL_SLOTS_SECTION), header.cellSlots,
+                image_->getSection(CELL_ENTRIES_SECTION), header.transitions);
+  targetStatesData_ = image_->getSection(TARGET_STATES_SECTION);
+  pushStartData_ = image_->getSection(PUSH_START_SECTION);
+  pushSymbolsData_ = image_->getSection(PUSH_SYMBOLS_SECTION);
+  deterministic_ = header.deterministic;
+  indexFinalStates();
+  epsilon_.restore(header.transitions, header.inputs, header.stackSymbols, header.analysisComplete,
+                   image_->getSection(ANALYSIS_FLAGS_SECTION), image_->getSection(ANALYSIS_STARTS_SECTION),
+                   image_->getSection(WEIGHTS_SECTION));
+  loaded_ = true;
+}
+
+// The automaton of the grammar is the usual one of a single state: an e-transition replaces a nonterminal
+// on the top by a right side of it and every terminal is popped when it is read. It is used by the trace
+// and when the grammar is not LALR(1).
+void PushDownAutomaton::loadGrammar (string fileName) {
+  grammar_ = new Grammar ();
+  inputIds_.intern("e");  // EPSILON
+  if (!grammar_->load(fileName, inputIds_))
+    return;
+
+  string terminals;
+  string nonterminals;
+  for (symbol_t id = EPSILON + 1; id < inputIds_.size(); id++)
+    terminals += (terminals != "" ? " " : "") + inputIds_.name(id);
+  for (unsigned i = 0; i < grammar_->getNonterminalCount(); i++)
+    if (i != grammar_->getStart())
+      nonterminals += " " + grammar_->symbolName(i);
+  const production_t& start = grammar_->getProductions()[grammar_->getProductionsOf(grammar_->getStart())[0]];
+  readStates("q0");
+  readInputSymbols(terminals);
+  readStackSymbols(terminals + nonterminals);
+  readInitialState("q0");
+  readInitialStackSymbol(grammar_->symbolName(start.rhs[0]));
+  readFinalStates("q0");
+
+  // The automaton can't move at the end of the input, so the symbols left on the stack then could not
+  // derive the empty word like they do for the parsers. Every production also has the right sides without
+  // the nullable symbols it ends with, the search leaves them out when nothing is read after them.
+  const vector<production_t>& productions = grammar_->getProductions();
+  set<string> saved;
+  for (unsigned i = 0; i < productions.size(); i++) {
+    if (productions[i].lhs == grammar_->getStart())
+      continue;
+    const vector<gsymbol_t>& rhs = productions[i].rhs;
+    unsigned end = rhs.size();
+    do {
+      string push;
+      for (unsigned j = 0; j < end; j++)
+        push += grammar_->symbolName(rhs[j]);
+      string transition = "q0 e " + grammar_->symbolName(productions[i].lhs) + " q0 " + (push != "" ? push : "e");
+      if (saved.insert(transition).second)
+        saveTransition(transition);
+    } while (end > 0 && !isTerminal(rhs[end - 1]) && grammar_->isNullable(rhs[--end]));
+  }
+  for (symbol_t id = EPSILON + 1; id < inputIds_.size(); id++)
+    saveTransition("q0 " + inputIds_.name(id) + " " + inputIds_.name(id) + " q0 e");
+  buildTransitionTable();
+
+  lalr_ = new LalrTable (*grammar_);
+  if (lalr_->hasConflicts())
+    cerr << "The grammar is not LALR(1) (" << lalr_->getConflicts().size()
+         << " conflicts), its inputs are checked with the automaton" << endl;
+  loaded_ = true;
+}
+
+bool PushDownAutomaton::readImageNames (SymbolTable& symbols, image_section_t section, unsigned size) {
+  for (symbol_t id = 0; id < size; id++)
+    if (symbols.intern(image_->getString(section, id)) != id)
+      return false;
+  return symbols.size() == size;
+}
+
+void PushDownAutomaton::indexFinalStates () {
+  finalStateIds_.assign(stateIds_.size(), false);
+  for (int i = 0; i < finalStates_.size(); i++) {
+    symbol_t state = stateIds_.find(finalStates_[i]);
+    if (state != NO_SYMBOL)
+      finalStateIds_[state] = true;
   }
 }
 
 
+// For every state and stack top, an e-transition excludes any other transition and every input symbol
+// has at most one transition. Only the cells with transitions are looked at.
+bool PushDownAutomaton::checkDeterminism () const {
+  const cell_slot_t* slots = table_.getSlots();
+  for (unsigned slot = 0; slot < table_.getSlotCount(); slot++) {
+    const cell_slot_t& cell = slots[slot];
+    if (cell.state == NO_SYMBOL)
+      continue;
+    if (cell.end - cell.begin > 1)
+      return false;
+    const unsigned* begin;
+    const unsigned* end;
+    table_.getRange(cell.state, EPSILON, cell.top, begin, end);
+    if (cell.input != EPSILON && begin != end)
+      return false;
+  }
+  return true;
+}
+
 // Show all description of the automaton.
 void PushDownAutomaton::show () {
   vector<string> acceptedSymbols = stack_->getAcceptedSymbols();
-  string initialStackSymbol = stack_->getInitialSymbol ();
+  string initialStackSymbol = stack_->getInitialSymbolName ();
 
   cout << "States: {";
   for (int i = 0;i < states_.size(); i++) {
@@ -343,9 +620,32 @@ void PushDownAutomaton::show () {
     }
   }
 
+  if (deterministic_)
+    cout << "Deterministic: inputs are checked in a single pass" << endl;
+  if (lalr_ != NULL && !lalr_->hasConflicts())
+    cout << "LALR(1): " << lalr_->getStateCount() << " states, inputs are checked in a single pass" << endl;
+  else if (lalr_ != NULL) {
+    cout << "LALR(1) conflicts, inputs are checked with the automaton:" << endl;
+    for (unsigned i = 0; i < lalr_->getConflicts().size(); i++)
+      cout << "  " << lalr_->getConflicts()[i] << endl;
+  }
+  cout << "Input needed to pop:";
+  for (symbol_t id = 0; id < stackAlphabetSize_; id++) {
+    unsigned weight = epsilon_.getWeight(id);
+    cout << " " << stackIds_.name(id) << " " << (weight < MAX_WEIGHT ? to_string(weight) : "never");
+  }
+  cout << endl;
+  if (!epsilon_.isComplete())
+    cout << "E-transitions: too many to analyse, nothing is pruned by them" << endl;
+
   cout << "Transitions: "<< endl;
   for (int i = 0;i < transitions_.size(); i++) {
-    cout << "(" << transitions_[i].first << ") -->  (" << transitions_[i].second << ")" << endl;
+    cout << "(" << transitions_[i].actual << ") -->  (" << transitions_[i].next << ")";
+    if (epsilon_.isDead(i))
+      cout << "  never reads again";
+    else if (epsilon_.isGrowing(i))
+      cout << "  grows the stack without reading";
+    cout << endl;
   }
   cout << endl;
 }
@@ -7,7 +7,7 @@
 *
 ***/
 #ifndef _PUSH_DOWN_AUTOMATON_HPP_
-#define _PUSH_DOWN_AUTOMATON_HPP
+#define _PUSH_DOWN_AUTOMATON_HPP_
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -19,12 +19,32 @@
 #include "Utils.hpp"  // lineToString, charToString
 #include <utility>    // pair class
 #include "Stack.hpp"
+#include "SharedStack.hpp"
 #include "InTape.hpp"
+#include "Tokenizer.hpp"
+#include "SymbolTable.hpp"
+#include "TransitionTable.hpp"
+#include "Search.hpp"
+#include "ParallelSearch.hpp"
+#include "Grammar.hpp"
+#include "EarleyRecognizer.hpp"
+#include "DeterministicRunner.hpp"
+#include "AutomatonImage.hpp"
+#include "TraceSink.hpp"
+#include "TraceFormatter.hpp"
+#include "RunConfig.hpp"
+#include "TapeStream.hpp"
+#include "SearchStatistics.hpp"
+#include "EpsilonAnalysis.hpp"
+#include "LalrTable.hpp"
+#include "ShiftReduceParser.hpp"
+#include "IncrementalChecker.hpp"
 
 using namespace std;
 
-// I save the transitions as strings so I just compare them to determine whether a transition can be executed.
-typedef pair<string, string> transition_t;
+// How checkInput decides if the input is accepted: searching the configurations of the automaton or
+// parsing the input with the grammar of the automaton.
+enum engine_t { SEARCH_ENGINE, EARLEY_ENGINE };
 
 // Pushdown automaton that works by final state
 class PushDownAutomaton {
@@ -34,13 +54,40 @@ class PushDownAutomaton {
 	vector<transition_t> transitions_;
 	string initialState_;
 
+	// Interned ids of the states and symbols, used to index the transition table.
+	SymbolTable stateIds_;
+	SymbolTable inputIds_;
+	SymbolTable stackIds_;
+	unsigned stackAlphabetSize_;   // The declared stack symbols are the first ids of stackIds_.
+	vector<bool> finalStateIds_;
+	TransitionTable table_;
+	// Target of every transition, tokenized once: next state and symbols to push in push order (the new
+	// top is the last one). The data pointers point into the vectors or into the image.
+	vector<symbol_t> targetStates_;
+	vector<unsigned> pushStart_;     // Where the symbols of every transition begin (one extra at the end).
+	vector<symbol_t> pushSymbols_;
+	const symbol_t* targetStatesData_;
+	const unsigned* pushStartData_;
+	const symbol_t* pushSymbolsData_;
+	bool deterministic_;   // At most one transition can be taken in every configuration.
+	bool loaded_;          // The automaton file could be read.
+	EpsilonAnalysis epsilon_;   // What the e-transitions can do, used to cut branches of the search.
+	AutomatonImage* image_;   // Image the automaton was loaded from, NULL for a text file.
 
 	Stack* stack_;
 	InTape* inputTape_;
-	string actualState_;
-	bool acceptedInput_;
-	map<string, int> passedPoints;
-	vector<string> transactionHistory;
+	symbol_t actualState_;
+	check_result_t result_;
+	search_statistics_t statistics_;   // Counters of the last check, kept when the configuration asks for them.
+
+	// Execution settings
+	search_t search_;
+	RunConfig config_;            // Limits of every check.
+	engine_t engine_;
+	Grammar* grammar_;            // Built the first time the Earley engine is chosen, or read from a grammar file.
+	LalrTable* lalr_;             // Parse table of a grammar file, NULL for an automaton file.
+	string usage_;                // What the last check did.
+	IncrementalChecker* incremental_;   // Configurations of the last input checked, kept in incremental mode.
 
 public:
 	PushDownAutomaton(string fileName);
@@ -49,19 +96,55 @@ public:
 	// Initialization methods
 	void loadInput (string fileName);
 	void loadInputByKeyboard ();
-	void loadAutomaton (string fileName);
+	void loadAutomaton (string fileName);   // Text format, compiled image or grammar file.
+	bool compile (string fileName) const;    // Write the compiled image of the automaton.
 
 	// Execution methods
-	bool checkInput (bool trace);
-	void nextStep (string actualState, InTape input, Stack stack, int readCount, bool trace);   // Recursive method to try all possible transition combinations until input is accepted.
-	vector<transition_t> getAllowedTransitionsForState (string state, InTape input, Stack stack);
-	void showActualTraceInfo (string state, InTape input, Stack stack, vector<transition_t> allowed);
-	void showAllowedTransitions (vector<transition_t> transitions);
+	check_result_t checkInput (bool trace);
+	check_result_t checkTape (const vector<symbol_t>& tape) const;   // Quiet check that can run in several threads at once.
+	vector<symbol_t> readTape (const InTape& input) const;  // Input symbol ids of a tape.
+	check_result_t checkStream (TapeStream& tape);   // Check the input while it is read.
+	bool canStream () const;   // The input of checkStream doesn't have to be read ahead without bound.
+	void setSearch (search_t search) { search_ = search; };
+	search_t getSearch () { return search_; };
+	void setRunConfig (const RunConfig& config) {
+		config_ = config;
+		delete incremental_;   // It was built with the old limits.
+		incremental_ = NULL;
+		if (config.hasSearch())
+			search_ = config.getSearch();
+	};
+	const RunConfig& getRunConfig () const { return config_; };
+	void setEngine (engine_t engine);
+	engine_t getEngine () const { return engine_; };
+	void showSearchUsage ();
+	void showStatistics ();
+	const search_statistics_t& getStatistics () const { return statistics_; };
 	bool isFinalState (string state);
+	bool isFinalState (symbol_t state) const;
 
 	// Display automaton
 	void show ();
 
+	// Getters used by the engines
+	const SymbolTable& getStates () const { return stateIds_; };
+	const SymbolTable& getInputSymbols () const { return inputIds_; };
+	const SymbolTable& getStackSymbols () const { return stackIds_; };
+	unsigned getStackAlphabetSize () const { return stackAlphabetSize_; };
+	const vector<transition_t>& getTransitions () const { return transitions_; };
+	const TransitionTable& getTransitionTable () const { return table_; };
+	const EpsilonAnalysis& getEpsilonAnalysis () const { return epsilon_; };
+	symbol_t getInitialState () const { return actualState_; };
+	bool isDeterministic () const { return deterministic_; };
+	bool isLoaded () const { return loaded_; };
+	bool hasParser () const { return lalr_ != NULL && !lalr_->hasConflicts(); };   // Inputs are checked by the LALR(1) table.
+	vector<symbol_t> getInitialStack () const;
+	vector<string> getDefinition () const;   // First six lines of the automaton file.
+	void readTarget (unsigned transition, symbol_t& state, vector<symbol_t>& symbols) const;
+	symbol_t getTargetState (unsigned transition) const { return targetStatesData_[transition]; };
+	const symbol_t* pushBegin (unsigned transition) const { return pushSymbolsData_ + pushStartData_[transition]; };
+	const symbol_t* pushEnd (unsigned transition) const { return pushSymbolsData_ + pushStartData_[transition + 1]; };
+
 private:
 	// For initialization the PushDown automaton
 	void readStates (string states);
@@ -71,6 +154,14 @@ private:
 	void readInitialStackSymbol (string symbol);
 	void readFinalStates (string states);
 	void saveTransition (string transition);
+	void buildTransitionTable ();
+	void loadImage (string fileName);
+	void loadGrammar (string fileName);
+	bool readImageNames (SymbolTable& symbols, image_section_t section, unsigned size);
+	void indexFinalStates ();
+	bool checkDeterminism () const;
+	void initSettings ();
+	void showTrace (const TraceSink& sink);
 };
 
 #endif
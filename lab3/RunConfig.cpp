@@ -0,0 +1,237 @@
+#include "RunConfig.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <cerrno>
+
+// Environment variable of every option.
+static const char* OPTIONS[][2] = {
+  { "--max-depth", "STACK_MAX_DEPTH" },
+  { "--max-configurations", "MAX_CONFIGURATIONS" },
+  { "--max-memory", "MAX_MEMORY" },
+  { "--deadline-ms", "DEADLINE_MS" },
+  { "--threads", "SEARCH_THREADS" },
+  { "--trace-file", "TRACE_FILE" },
+  { "--search", "SEARCH_ORDER" }
+};
+static const unsigned OPTION_COUNT = sizeof(OPTIONS) / sizeof(OPTIONS[0]);
+// Options without a value, they are turned off with "0".
+static const char* FLAGS[][2] = {
+  { "--statistics", "SEARCH_STATISTICS" },
+  { "--incremental", "INCREMENTAL_CHECK" }
+};
+static const unsigned FLAG_COUNT = sizeof(FLAGS) / sizeof(FLAGS[0]);
+
+
+check_result_t makeResult (bool accepted, budget_t stopped, bool depthCut) {
+  check_result_t result;
+  result.budget = NO_BUDGET;
+  if (accepted)
+    result.verdict = INPUT_ACCEPTED;
+  else if (stopped != NO_BUDGET || depthCut) {
+    result.verdict = BUDGET_EXHAUSTED;
+    result.budget = stopped != NO_BUDGET ? stopped : DEPTH_BUDGET;
+  }
+  else
+    result.verdict = INPUT_REJECTED;
+  return result;
+}
+
+RunConfig::RunConfig () {
+  stackMaxDepth_ = 0;
+  maxConfigurations_ = NO_LIMIT;
+  maxMemory_ = DEFAULT_MAX_MEMORY;
+  deadline_ = 0;
+  threads_ = 1;
+  statistics_ = false;
+  incremental_ = false;
+  search_ = DEPTH_FIRST;
+  hasSearch_ = false;
+}
+
+RunConfig::~RunConfig () {}
+
+bool RunConfig::readEnvironment () {
+  for (unsigned i = 0; i < OPTION_COUNT; i++)
+    if (getenv(OPTIONS[i][1]) != NULL && !setOption(OPTIONS[i][0], getenv(OPTIONS[i][1]), OPTIONS[i][1]))
+      return false;
+  for (unsigned i = 0; i < FLAG_COUNT; i++)
+    if (getenv(FLAGS[i][1]) != NULL)
+      setFlag(FLAGS[i][0], getenv(FLAGS[i][1]));
+  return true;
+}
+
+bool RunConfig::readArguments (vector<string>& args) {
+  vector<string> rest;
+  for (unsigned i = 0; i < args.size(); i++) {
+    string name = args[i];
+    string value;
+    bool known = false;
+    size_t equal = name.find('=');
+    if (equal != string::npos) {
+      value = name.substr(equal + 1);
+      name = name.substr(0, equal);
+    }
+    for (unsigned j = 0; j < OPTION_COUNT; j++)
+      known = known || name == OPTIONS[j][0];
+    bool flag = false;
+    for (unsigned j = 0; j < FLAG_COUNT; j++)
+      flag = flag || name == FLAGS[j][0];
+
+    if (flag) {
+      setFlag(name, equal == string::npos ? "1" : value);
+      continue;
+    }
+    if (!known) {
+      rest.push_back(args[i]);
+      continue;
+    }
+    if (equal == string::npos) {
+      if (i + 1 == args.size()) {
+        cerr << "Missing value of " << name << endl;
+        return false;
+      }
+      value = args[++i];
+    }
+    if (!setOption(name, value, name))
+      return false;
+  }
+  args = rest;
+  return true;
+}
+
+// The source is the option or the environment variable the value was given with, for the errors.
+bool RunConfig::setOption (const string& name, const string& value, const string& source) {
+  if (name == "--trace-file") {
+    traceFile_ = value;
+    return true;
+  }
+  if (name == "--search") {
+    for (unsigned i = 0; i < SEARCH_COUNT; i++)
+      if (value == getSearchName((search_t) i)) {
+        search_ = (search_t) i;
+        hasSearch_ = true;
+        return true;
+      }
+    cerr << "Wrong value of " << source << ": " << value << endl;
+    return false;
+  }
+
+  if (name == "--threads") {
+    if (!readThreads(value, threads_)) {
+      cerr << "Wrong value of " << source << ": " << value << " (from 1 to " << MAX_THREADS << " threads)" << endl;
+      return false;
+    }
+    return true;
+  }
+
+  // The depth is kept in an unsigned, the deadline is added to the clock in nanoseconds.
+  unsigned long maximum = NO_LIMIT;
+  if (name == "--max-depth")
+    maximum = ~0u;
+  else if (name == "--deadline-ms")
+    maximum = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::duration::max()).count() / 2;
+  unsigned long number;
+  if (!readNumber(value, maximum, number)) {
+    cerr << "Wrong value of " << source << ": " << value << " (a number up to " << maximum << " was expected)" << endl;
+    return false;
+  }
+  if (name == "--max-depth")
+    stackMaxDepth_ = number;
+  else if (name == "--max-configurations")
+    maxConfigurations_ = number;
+  else if (name == "--max-memory")
+    maxMemory_ = number;
+  else if (name == "--deadline-ms")
+    deadline_ = number;
+  return true;
+}
+
+void RunConfig::setFlag (const string& name, const string& value) {
+  if (name == "--statistics")
+    statistics_ = value != "0" && value != "";
+  else if (name == "--incremental")
+    incremental_ = value != "0" && value != "";
+}
+
+// Decimal number with an optional K, M or G suffix (powers of 1024), up to the maximum. strtoul takes a
+// sign and negates the number, so only digits are allowed at the beginning.
+bool RunConfig::readNumber (const string& value, unsigned long maximum, unsigned long& number) {
+  if (value.empty() || value[0] < '0' || value[0] > '9')
+    return false;
+  char* end;
+  errno = 0;
+  number = strtoul(value.c_str(), &end, 10);
+  if (errno == ERANGE)
+    return false;
+  string suffix = end;
+  unsigned shift = 0;
+  if (suffix == "K" || suffix == "k")
+    shift = 10;
+  else if (suffix == "M" || suffix == "m")
+    shift = 20;
+  else if (suffix == "G" || suffix == "g")
+    shift = 30;
+  else if (suffix != "")
+    return false;
+  if (number > maximum >> shift)
+    return false;
+  number <<= shift;
+  return true;
+}
+
+bool RunConfig::readThreads (const string& value, unsigned& threads) {
+  unsigned long number;
+  if (!readNumber(value, MAX_THREADS, number) || number == 0)
+    return false;
+  threads = number;
+  return true;
+}
+
+chrono::steady_clock::time_point RunConfig::startDeadline () const {
+  if (deadline_ == 0)
+    return chrono::steady_clock::time_point::max();
+  return chrono::steady_clock::now() + chrono::milliseconds(deadline_);
+}
+
+string RunConfig::describe (budget_t budget) const {
+  switch (budget) {
+    case DEPTH_BUDGET: return getBudgetName(budget) + " (" + to_string(stackMaxDepth_) + " symbols)";
+    case CONFIGURATION_BUDGET: return getBudgetName(budget) + " (" + to_string(maxConfigurations_) + " configurations)";
+    case MEMORY_BUDGET: return getBudgetName(budget) + " (" + to_string(maxMemory_) + " bytes)";
+    case TIME_BUDGET: return getBudgetName(budget) + " (" + to_string(deadline_) + " ms)";
+    default: return getBudgetName(budget);
+  }
+}
+
+string RunConfig::getSearchName (search_t search) {
+  switch (search) {
+    case BREADTH_FIRST: return "breadth-first";
+    case ITERATIVE_DEEPENING: return "iterative-deepening";
+    case BEST_FIRST: return "best-first";
+    default: return "depth-first";
+  }
+}
+
+string RunConfig::getBudgetName (budget_t budget) {
+  switch (budget) {
+    case DEPTH_BUDGET: return "stack depth";
+    case CONFIGURATION_BUDGET: return "configurations";
+    case MEMORY_BUDGET: return "memory";
+    case TIME_BUDGET: return "deadline";
+    default: return "none";
+  }
+}
+
+string RunConfig::getUsage () {
+  return "Options (or environment variables):\n"
+         "  --max-depth N             STACK_MAX_DEPTH     Deepest stack a configuration can have (no limit).\n"
+         "  --max-configurations N    MAX_CONFIGURATIONS  Configurations a check can explore.\n"
+         "  --max-memory N[K|M|G]     MAX_MEMORY          Bytes a search can keep in memory.\n"
+         "  --deadline-ms N           DEADLINE_MS         Milliseconds a check can run.\n"
+         "  --threads N               SEARCH_THREADS      Threads of the parallel search.\n"
+         "  --trace-file FILE         TRACE_FILE          Where the trace is written.\n"
+         "  --search ORDER            SEARCH_ORDER        depth-first, breadth-first, iterative-deepening or best-first.\n"
+         "  --statistics              SEARCH_STATISTICS   Show the counters of every check.\n"
+         "  --incremental             INCREMENTAL_CHECK   Keep the configurations of the input to check it again after it changes,\n"
+         "                                                in batch mode the words share the ones of their common prefixes.\n";
+}
@@ -0,0 +1,84 @@
+/***
+* @description: Execution limits of a check, read once from the environment and the command line, and the
+*               result of a check: accepted, rejected or stopped because one of the budgets ran out.
+***/
+#ifndef _RUN_CONFIG_HPP_
+#define _RUN_CONFIG_HPP_
+#include <string>
+#include <vector>
+#include <chrono>
+
+using namespace std;
+
+const unsigned long NO_LIMIT = ~0ul;
+const unsigned long DEFAULT_MAX_MEMORY = 1ul << 30;   // Bytes a search can keep in memory.
+const unsigned MAX_THREADS = 1024;
+
+enum budget_t { NO_BUDGET, DEPTH_BUDGET, CONFIGURATION_BUDGET, MEMORY_BUDGET, TIME_BUDGET };
+enum verdict_t { INPUT_ACCEPTED, INPUT_REJECTED, BUDGET_EXHAUSTED };
+
+// Order in which the search expands the configurations: depth-first in the order of the automaton file,
+// breadth-first, depth-first with a stack depth limit that doubles until no branch is cut by it, or the
+// configurations with less input left (and then with smaller stacks) first.
+enum search_t { DEPTH_FIRST, BREADTH_FIRST, ITERATIVE_DEEPENING, BEST_FIRST };
+const unsigned SEARCH_COUNT = 4;
+
+struct check_result_t {
+  verdict_t verdict;
+  budget_t budget;   // The budget that ran out, only for BUDGET_EXHAUSTED.
+};
+
+// Result of an engine: a rejection is only final if no budget stopped the search or cut one of its branches.
+check_result_t makeResult (bool accepted, budget_t stopped, bool depthCut);
+
+class RunConfig {
+  unsigned stackMaxDepth_;          // 0 until it is given, there is no depth limit then.
+  unsigned long maxConfigurations_; // Configurations a check can explore.
+  unsigned long maxMemory_;         // Bytes the configurations, stacks and passed points of a search can take.
+  unsigned long deadline_;          // Milliseconds a check can run, 0 for no deadline.
+  unsigned threads_;                // More than one runs the parallel search.
+  string traceFile_;                // Where the trace is written, empty to show it when the check ends.
+  bool statistics_;                 // Count what every check does.
+  bool incremental_;                // Keep the configurations of every position between checks of the input.
+  search_t search_;
+  bool hasSearch_;                  // The search order was given.
+
+public:
+  RunConfig ();
+  ~RunConfig ();
+
+  // STACK_MAX_DEPTH, MAX_CONFIGURATIONS, MAX_MEMORY, DEADLINE_MS, SEARCH_THREADS, TRACE_FILE, SEARCH_ORDER
+  // and the flags SEARCH_STATISTICS and INCREMENTAL_CHECK.
+  bool readEnvironment ();
+  // --max-depth, --max-configurations, --max-memory, --deadline-ms, --threads, --trace-file and --search, given as
+  // "--option value" or "--option=value", and --statistics and --incremental. They are taken out of the
+  // arguments, which override the environment.
+  bool readArguments (vector<string>& args);
+
+  bool hasStackMaxDepth () const { return stackMaxDepth_ > 0; };
+  unsigned getStackMaxDepth () const { return stackMaxDepth_ > 0 ? stackMaxDepth_ : ~0u; };
+  unsigned long getMaxConfigurations () const { return maxConfigurations_; };
+  unsigned long getMaxMemory () const { return maxMemory_; };
+  unsigned long getDeadline () const { return deadline_; };
+  unsigned getThreads () const { return threads_; };
+  const string& getTraceFile () const { return traceFile_; };
+  bool hasSearch () const { return hasSearch_; };
+  search_t getSearch () const { return search_; };
+  bool hasStatistics () const { return statistics_; };
+  bool isIncremental () const { return incremental_; };
+  void setThreads (unsigned threads) { threads_ = threads; };
+
+  chrono::steady_clock::time_point startDeadline () const;   // When a check starting now has to stop.
+  string describe (budget_t budget) const;                    // Name and value of the budget.
+  static string getBudgetName (budget_t budget);
+  static string getSearchName (search_t search);
+  static string getUsage ();
+  static bool readThreads (const string& value, unsigned& threads);   // From 1 to MAX_THREADS.
+
+private:
+  bool setOption (const string& name, const string& value, const string& source);
+  void setFlag (const string& name, const string& value);
+  static bool readNumber (const string& value, unsigned long maximum, unsigned long& number);
+};
+
+#endif
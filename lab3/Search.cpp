@@ -0,0 +1,380 @@
+#include "Search.hpp"
+#include "PushDownAutomaton.hpp"
+
+
+Search::Search (const PushDownAutomaton& automaton, const vector<symbol_t>& tape, search_t order, const RunConfig& config)
+  : automaton_(automaton), tape_(tape), config_(config) {
+  input_ = NULL;
+  order_ = order;
+  trace_ = NULL;
+  statistics_ = NULL;
+  verbose_ = true;
+  accepted_ = false;
+  acceptedIndex_ = NO_PARENT;
+  stopped_ = NO_BUDGET;
+  depthCut_ = false;
+  depthLimit_ = config_.getStackMaxDepth();
+  iterationCut_ = false;
+  iterations_ = 0;
+  explored_ = 0;
+  peakConfigurations_ = 0;
+  peakStackNodes_ = 0;
+}
+
+Search::~Search () {}
+
+bool Search::run () {
+  configuration_t initial;
+  initial.state = automaton_.getInitialState();
+  initial.pos = 0;
+  initial.stack = EMPTY_STACK;
+  vector<symbol_t> initialStack = automaton_.getInitialStack();
+  for (unsigned i = 0; i < initialStack.size(); i++)
+    initial.stack = stacks_.push(initial.stack, initialStack[i], automaton_.getEpsilonAnalysis().getWeight(initialStack[i]));
+  initial.parent = NO_PARENT;
+  initial.transition = NO_TRANSITION;
+  initial.stackMark = stacks_.mark();
+  deadline_ = config_.startDeadline();
+
+  if (trace_ != NULL) {
+    vector<string> text;
+    for (unsigned i = 0; i < tape_.size(); i++) {
+      if (input_ != NULL)
+        text.push_back(string(input_->getChar(i)));
+      else
+        text.push_back(tape_[i] == NO_SYMBOL ? "?" : automaton_.getInputSymbols().name(tape_[i]));
+    }
+    trace_->begin(automaton_, text, tape_);
+    traceNodes(EMPTY_STACK + 1);
+  }
+  if (order_ == BREADTH_FIRST)
+    searchBreadthFirst (initial);
+  else if (order_ == ITERATIVE_DEEPENING)
+    searchDeepening (initial);
+  else if (order_ == BEST_FIRST)
+    searchBestFirst (initial);
+  else
+    searchDepthFirst (initial);
+  return accepted_;
+}
+
+string parseConfiguration(string stackLine, string state, string input) {
+  return "(" + state + "," +
+         input + "," +
+         stackLine + ")";
+}
+
+// Print the derivation that leads to the configuration. It is rebuilt from the parents, so it has to be
+// called while the configurations of the path and their stacks are still kept.
+void Search::printConfiguration (unsigned index) {
+  vector<unsigned> path;
+  for (unsigned i = index; configurations_[i].parent != NO_PARENT; i = configurations_[i].parent)
+    path.push_back(i);
+
+  cout << "Configuration: ";
+  for (int i = path.size() - 1; i >= 0; i--) {
+    const configuration_t& configuration = configurations_[path[i]];
+    symbol_t from = automaton_.getTransitions()[configuration.transition].state;
+    cout << parseConfiguration(stacks_.getStackLine(configuration.stack, automaton_.getStackSymbols()),
+                               automaton_.getStates().name(from), getInput(configuration.pos)) << " |- ";
+  }
+  cout << endl;
+}
+
+void Search::showDerivation () {
+  if (accepted_ && acceptedIndex_ != NO_PARENT)
+    printConfiguration(acceptedIndex_);
+}
+
+// Stack nodes created since the mark, so the trace can rebuild the stacks.
+void Search::traceNodes (unsigned mark) {
+  for (stack_ref node = mark; node < stacks_.getNodeCount(); node++)
+    trace_->record(NODE_EVENT, node, stacks_.getTop(node), stacks_.pop(node));
+}
+
+// Depth-first search with an explicit stack of configurations: the last one is expanded one transition
+// at a time, so transitions are tried in the same order as the automaton file.
+void Search::searchDepthFirst (configuration_t initial) {
+  configurations_.push_back(initial);
+  if (!enterConfiguration(0))
+    configurations_.pop_back();
+
+  while (!configurations_.empty() && !accepted_ && stopped_ == NO_BUDGET) {
+    unsigned index = configurations_.size() - 1;
+    unsigned transition = nextTransition(configurations_[index]);
+    if (transition == NO_TRANSITION) {
+      stacks_.release(configurations_[index].stackMark);
+      configurations_.pop_back();
+      continue;
+    }
+
+    configurations_.push_back(takeTransition(index, transition));
+    if (isPassedPoint(index + 1) || !enterConfiguration(index + 1)) {
+      stacks_.release(configurations_.back().stackMark);
+      configurations_.pop_back();
+    }
+  }
+}
+
+// Breadth-first search: every configuration of the frontier is expanded at once. Stack nodes are shared
+// by the whole frontier so they are kept until the search ends.
+void Search::searchBreadthFirst (configuration_t initial) {
+  configurations_.push_back(initial);
+  if (enterConfiguration(0))
+    frontier_.push_back(0);
+
+  while (!frontier_.empty() && !accepted_ && stopped_ == NO_BUDGET) {
+    unsigned index = frontier_.front();
+    frontier_.pop_front();
+
+    unsigned transition;
+    while (!accepted_ && stopped_ == NO_BUDGET && (transition = nextTransition(configurations_[index])) != NO_TRANSITION) {
+      configurations_.push_back(takeTransition(index, transition));
+      unsigned child = configurations_.size() - 1;
+      if (isPassedPoint(child))
+        configurations_.pop_back();
+      else if (enterConfiguration(child))
+        frontier_.push_back(child);
+    }
+  }
+}
+
+// Depth-first searches with a stack depth limit that doubles while a branch was cut by it. The passed
+// points are only valid for one limit, the stack nodes of the initial configuration are kept. The work of
+// every iteration counts for the budgets.
+void Search::searchDeepening (configuration_t initial) {
+  depthLimit_ = min(DEEPENING_START, config_.getStackMaxDepth());
+  while (true) {
+    iterations_++;
+    iterationCut_ = false;
+    searchDepthFirst(initial);
+    if (accepted_ || stopped_ != NO_BUDGET || !iterationCut_)
+      return;
+    depthLimit_ = depthLimit_ > config_.getStackMaxDepth() / 2 ? config_.getStackMaxDepth() : depthLimit_ * 2;
+    configurations_.clear();
+    passedPoints_.clear();
+    stacks_.release(initial.stackMark);
+  }
+}
+
+// Like the breadth-first search, but the configuration expanded next is the one with less input left,
+// and then the one with the smallest stack.
+void Search::searchBestFirst (configuration_t initial) {
+  configurations_.push_back(initial);
+  if (enterConfiguration(0))
+    ranked_.push(rank(0));
+
+  while (!ranked_.empty() && !accepted_ && stopped_ == NO_BUDGET) {
+    unsigned index = ranked_.top().second;
+    ranked_.pop();
+
+    unsigned transition;
+    while (!accepted_ && stopped_ == NO_BUDGET && (transition = nextTransition(configurations_[index])) != NO_TRANSITION) {
+      configurations_.push_back(takeTransition(index, transition));
+      unsigned child = configurations_.size() - 1;
+      if (isPassedPoint(child))
+        configurations_.pop_back();
+      else if (enterConfiguration(child))
+        ranked_.push(rank(child));
+    }
+  }
+}
+
+Search::ranked_t Search::rank (unsigned index) const {
+  const configuration_t& configuration = configurations_[index];
+  unsigned long long left = tape_.size() - configuration.pos;
+  return ranked_t(left << 32 | stacks_.getSize(configuration.stack), index);
+}
+
+// What the automaton does when it arrives to a configuration: accept the input, stop the branch or
+// prepare its transitions to be expanded (returns true in that case).
+bool Search::enterConfiguration (unsigned index) {
+  configuration_t& configuration = configurations_[index];
+  peakConfigurations_ = max(peakConfigurations_, (unsigned) configurations_.size());
+  peakStackNodes_ = max(peakStackNodes_, stacks_.getNodeCount());
+  stopped_ = checkBudgets();
+  if (stopped_ != NO_BUDGET) {
+    if (trace_ != NULL)
+      trace_->record(BUDGET_EVENT, stopped_, 0, 0);
+    return false;
+  }
+
+  unsigned stackSize = stacks_.getSize(configuration.stack);
+  bool hasNext = configuration.pos < tape_.size();
+  if (!hasNext && !stackSize) {
+    if (automaton_.isFinalState(configuration.state)) {
+      if (trace_ != NULL)
+        trace_->record(ACCEPT_EVENT, configuration.state, configuration.pos, configuration.stack);
+      accepted_ = true;
+      acceptedIndex_ = index;
+    }
+  } else if (!hasNext || !stackSize)
+    return false;
+
+  // The stack needs more input than what is left to be emptied.
+  if (stacks_.getWeight(configuration.stack) > tape_.size() - configuration.pos) {
+    if (statistics_ != NULL)
+      statistics_->epsilonPrunes++;
+    return false;
+  }
+
+  const TransitionTable& table = automaton_.getTransitionTable();
+  symbol_t symbol = hasNext ? tape_[configuration.pos] : NO_SYMBOL;
+  symbol_t top = stacks_.getTop(configuration.stack);
+  table.getRange(configuration.state, symbol, top, configuration.read, configuration.readEnd);
+  table.getRange(configuration.state, EPSILON, top, configuration.empty, configuration.emptyEnd);
+
+  if (trace_ != NULL)
+    trace_->record(CONFIGURATION_EVENT, configuration.state, configuration.pos, configuration.stack);
+
+  if (stackSize > depthLimit_) {
+    if (depthLimit_ < config_.getStackMaxDepth())
+      iterationCut_ = true;
+    else
+      depthCut_ = true;
+    if (trace_ != NULL)
+      trace_->record(DEPTH_LIMIT_EVENT, configuration.state, configuration.pos, configuration.stack);
+    if (statistics_ != NULL)
+      statistics_->depthPrunes++;
+    return false;
+  }
+
+  passedPoints_.insert(configuration.state, configuration.pos, stacks_.getFingerprint(configuration.stack));
+  if (statistics_ != NULL) {
+    statistics_->expanded++;
+    statistics_->maxStackDepth = max(statistics_->maxStackDepth, stackSize);
+    unsigned long frontier = order_ == BREADTH_FIRST ? frontier_.size() + 1 :
+                             order_ == BEST_FIRST ? ranked_.size() + 1 : configurations_.size();
+    statistics_->maxFrontier = max(statistics_->maxFrontier, frontier);
+  }
+  return true;
+}
+
+// Budget that ran out when one more configuration is explored. The clock is only read every 1024 configurations.
+budget_t Search::checkBudgets () {
+  if (++explored_ > config_.getMaxConfigurations())
+    return CONFIGURATION_BUDGET;
+  if (getMemory() > config_.getMaxMemory())
+    return MEMORY_BUDGET;
+  if (explored_ % 1024 == 0 && chrono::steady_clock::now() > deadline_)
+    return TIME_BUDGET;
+  return NO_BUDGET;
+}
+
+// Bytes of the configurations, stack nodes and passed points kept right now.
+unsigned long Search::getMemory () const {
+  return (unsigned long) configurations_.size() * sizeof(configuration_t) + frontier_.size() * sizeof(unsigned) +
+         ranked_.size() * sizeof(ranked_t) +
+         (unsigned long) stacks_.getNodeCount() * sizeof(stack_node) + passedPoints_.getMemory();
+}
+
+// Next transition of the configuration, keeping the order of the automaton file. The ones after which
+// the input can't be read anymore, and the e-transitions that can't read the next symbol, are skipped.
+unsigned Search::nextTransition (configuration_t& configuration) {
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  while (configuration.read != configuration.readEnd || configuration.empty != configuration.emptyEnd) {
+    unsigned transition;
+    if (configuration.empty == configuration.emptyEnd ||
+        (configuration.read != configuration.readEnd && *configuration.read < *configuration.empty))
+      transition = *configuration.read++;
+    else
+      transition = *configuration.empty++;
+    if (analysis.isDead(transition)) {
+      if (statistics_ != NULL)
+        statistics_->epsilonPrunes++;
+      continue;
+    }
+    if (analysis.canStart(transition, tape_[configuration.pos]))
+      return transition;
+    if (statistics_ != NULL)
+      statistics_->firstPrunes++;
+  }
+  return NO_TRANSITION;
+}
+
+// Configuration reached from the configuration at index through the transition.
+configuration_t Search::takeTransition (unsigned index, unsigned transitionIndex) {
+  const configuration_t& actual = configurations_[index];
+  const transition_t& transition = automaton_.getTransitions()[transitionIndex];
+  configuration_t next;
+  next.parent = index;
+  next.transition = transitionIndex;
+  if (statistics_ != NULL)
+    statistics_->fired[transitionIndex]++;
+  next.stackMark = stacks_.mark();   // nodes pushed by this branch
+
+  next.pos = actual.pos;
+  if (transition.input != EPSILON)
+    next.pos++;  // e-transitions don't consume the input
+
+  next.state = automaton_.getTargetState(transitionIndex);
+
+  // The branch shares the stack below the top with its parent. The symbols were tokenized when the
+  // automaton was loaded, so nothing is parsed here.
+  const EpsilonAnalysis& analysis = automaton_.getEpsilonAnalysis();
+  next.stack = stacks_.pop(actual.stack);
+  for (const symbol_t* symbol = automaton_.pushBegin(transitionIndex); symbol != automaton_.pushEnd(transitionIndex); symbol++)
+    next.stack = stacks_.push(next.stack, *symbol, analysis.getWeight(*symbol));
+  if (trace_ != NULL)
+    traceNodes(next.stackMark);
+  return next;
+}
+
+// True (and the loop is reported) if the configuration was already passed: it is either being explored
+// (a loop) or it was explored without accepting the input.
+bool Search::isPassedPoint (unsigned index) {
+  const configuration_t& configuration = configurations_[index];
+  if (passedPoints_.contains(configuration.state, configuration.pos, stacks_.getFingerprint(configuration.stack))) {
+    if (trace_ != NULL)
+      trace_->record(LOOP_EVENT, configuration.state, configuration.pos, configuration.stack);
+    if (statistics_ != NULL) {
+      statistics_->memoHits++;
+      statistics_->loopPrunes += isOnPath(index);
+    }
+    return true;
+  }
+  if (statistics_ != NULL)
+    statistics_->memoMisses++;
+  return false;
+}
+
+// True if the configuration repeats one of the path that leads to it. The read position never goes back,
+// so only the configurations reached by e-transitions at the same position are compared.
+bool Search::isOnPath (unsigned index) const {
+  const configuration_t& configuration = configurations_[index];
+  fingerprint_t fingerprint = stacks_.getFingerprint(configuration.stack);
+  for (unsigned i = configuration.parent; i != NO_PARENT && configurations_[i].pos == configuration.pos;
+       i = configurations_[i].parent)
+    if (configurations_[i].state == configuration.state && stacks_.getFingerprint(configurations_[i].stack) == fingerprint)
+      return true;
+  return false;
+}
+
+// Configurations and stack nodes that the search kept in memory at the same time.
+const string Search::getUsage () const {
+  unsigned long bytes = (unsigned long) peakConfigurations_ * sizeof(configuration_t) +
+                        (unsigned long) peakStackNodes_ * sizeof(stack_node) + passedPoints_.getMemory();
+  ostringstream usage;
+  string name = RunConfig::getSearchName(order_);
+  name[0] = toupper(name[0]);
+  usage << name << " search kept up to "
+        << peakConfigurations_ << " configurations, " << peakStackNodes_ << " stack nodes and "
+        << passedPoints_.getSize() << " passed points (~" << bytes / 1024 << " KB)";
+  usage << ", " << explored_ << " explored";
+  if (order_ == ITERATIVE_DEEPENING)
+    usage << " in " << iterations_ << (iterations_ == 1 ? " iteration" : " iterations") << " up to depth " << depthLimit_;
+  if (stopped_ != NO_BUDGET)
+    usage << ", stopped by the " << config_.describe(stopped_) << " budget";
+  return usage.str();
+}
+
+// Rest of the input from the position, from the text of the tape when it is known.
+const string Search::getInput (unsigned pos) const {
+  if (input_ != NULL)
+    return input_->getInput(pos);
+
+  string res = "";
+  for (unsigned i = pos; i < tape_.size(); i++)
+    res += tape_[i] == NO_SYMBOL ? "?" : automaton_.getInputSymbols().name(tape_[i]);
+  return res;
+}
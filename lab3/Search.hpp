@@ -0,0 +1,91 @@
+/***
+* @description: Search of the configurations of a pushdown automaton for one input tape. It keeps its own
+*               frontier, stacks and passed points, so several searches can run on the same automaton.
+***/
+#ifndef _SEARCH_HPP_
+#define _SEARCH_HPP_
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include "SymbolTable.hpp"
+#include "SharedStack.hpp"
+#include "Configuration.hpp"
+#include "ConfigurationMemo.hpp"
+#include "InTape.hpp"
+#include "TraceSink.hpp"
+#include "RunConfig.hpp"
+#include "SearchStatistics.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+const unsigned DEEPENING_START = 8;   // Stack depth limit of the first iteration of iterative deepening.
+
+class Search {
+  const PushDownAutomaton& automaton_;
+  const vector<symbol_t>& tape_;   // Input symbol ids of the tape being checked.
+  const InTape* input_;            // Text of the tape for the trace and the derivation (can be NULL).
+  search_t order_;
+  const RunConfig& config_;
+  chrono::steady_clock::time_point deadline_;
+  TraceSink* trace_;               // Records every step of the search when it is not NULL.
+  search_statistics_t* statistics_;   // Counters of the search, updated when it is not NULL.
+  bool verbose_;                   // Show the messages of the search (the configuration limit).
+
+  SharedStack stacks_;                        // Stacks of every branch of the search.
+  vector<configuration_t> configurations_;   // Depth-first: the actual path. Breadth-first: every configuration.
+  deque<unsigned> frontier_;                  // Configurations still to expand (breadth-first).
+  // Configurations still to expand (best-first), by rank: input left, then stack size, then index.
+  typedef pair<unsigned long long, unsigned> ranked_t;
+  priority_queue<ranked_t, vector<ranked_t>, greater<ranked_t> > ranked_;
+  ConfigurationMemo passedPoints_;            // Configurations already visited by the search.
+
+  bool accepted_;
+  unsigned acceptedIndex_;         // Configuration that accepted the input.
+  budget_t stopped_;               // Budget that stopped the search.
+  bool depthCut_;                  // A branch was cut by the stack depth limit.
+  unsigned depthLimit_;            // Limit of this iteration, the one of the configuration but for iterative deepening.
+  bool iterationCut_;              // A branch was cut by a limit below the one of the configuration.
+  unsigned iterations_;
+  unsigned long explored_;
+  unsigned peakConfigurations_;
+  unsigned peakStackNodes_;
+
+public:
+  Search (const PushDownAutomaton& automaton, const vector<symbol_t>& tape, search_t order, const RunConfig& config);
+  ~Search ();
+
+  void setTrace (TraceSink* trace) { trace_ = trace; };
+  void setStatistics (search_statistics_t* statistics) { statistics_ = statistics; };
+  void setVerbose (bool verbose) { verbose_ = verbose; };
+  void setInput (const InTape* input) { input_ = input; };
+
+  bool run ();   // Try all possible transition combinations until input is accepted.
+  check_result_t getResult () const { return makeResult(accepted_, stopped_, depthCut_); };
+  const string getUsage () const;
+  unsigned long getExplored () const { return explored_; };
+  unsigned getIterations () const { return iterations_; };
+  void showDerivation ();   // Derivation of the accepted input.
+
+private:
+  void searchDepthFirst (configuration_t initial);
+  void searchBreadthFirst (configuration_t initial);
+  void searchDeepening (configuration_t initial);
+  void searchBestFirst (configuration_t initial);
+  ranked_t rank (unsigned index) const;
+  bool enterConfiguration (unsigned index);
+  budget_t checkBudgets ();
+  unsigned long getMemory () const;
+  unsigned nextTransition (configuration_t& configuration);
+  configuration_t takeTransition (unsigned index, unsigned transition);
+  bool isPassedPoint (unsigned index);
+  bool isOnPath (unsigned index) const;
+  void printConfiguration (unsigned index);
+  void traceNodes (unsigned mark);
+  const string getInput (unsigned pos) const;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "SearchStatistics.hpp"
+#include <algorithm>
+
+const unsigned SHOWN_TRANSITIONS = 10;
+
+void resetStatistics (search_statistics_t& statistics, unsigned transitions) {
+  statistics.expanded = 0;
+  statistics.memoHits = 0;
+  statistics.memoMisses = 0;
+  statistics.loopPrunes = 0;
+  statistics.depthPrunes = 0;
+  statistics.epsilonPrunes = 0;
+  statistics.firstPrunes = 0;
+  statistics.maxStackDepth = 0;
+  statistics.maxFrontier = 0;
+  statistics.fired.assign(transitions, 0);
+  statistics.seconds = 0;
+}
+
+void showStatistics (ostream& out, const search_statistics_t& statistics, const vector<transition_t>& transitions) {
+  out << "Configurations expanded: " << statistics.expanded << endl;
+  out << "Passed points: " << statistics.memoHits << " hits, " << statistics.memoMisses << " misses" << endl;
+  out << "Pruned: " << statistics.loopPrunes << " loops, " << statistics.depthPrunes << " by the depth limit, "
+      << statistics.epsilonPrunes << " by the e-transition analysis, " << statistics.firstPrunes
+      << " by the next symbol" << endl;
+  out << "Deepest stack: " << statistics.maxStackDepth << ", largest frontier: " << statistics.maxFrontier << endl;
+  out << "Elapsed: " << statistics.seconds << " s" << endl;
+
+  vector<unsigned> order;
+  for (unsigned i = 0; i < statistics.fired.size() && i < transitions.size(); i++)
+    if (statistics.fired[i] > 0)
+      order.push_back(i);
+  stable_sort(order.begin(), order.end(), [&statistics] (unsigned a, unsigned b) {
+    return statistics.fired[a] > statistics.fired[b];
+  });
+  if (order.size() > SHOWN_TRANSITIONS)
+    order.resize(SHOWN_TRANSITIONS);
+  if (!order.empty())
+    out << "Transitions taken the most:" << endl;
+  for (unsigned i = 0; i < order.size(); i++)
+    out << "  " << transitions[order[i]].actual << " -> " << transitions[order[i]].next << ": "
+        << statistics.fired[order[i]] << endl;
+}
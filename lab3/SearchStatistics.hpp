@@ -0,0 +1,31 @@
+/***
+* @description: Counters of what a check did. The engines only update them when they are given a place
+*               to keep them, like the trace, so a check without statistics doesn't pay for them.
+***/
+#ifndef _SEARCH_STATISTICS_HPP_
+#define _SEARCH_STATISTICS_HPP_
+#include <iostream>
+#include <vector>
+#include "TransitionTable.hpp"
+
+using namespace std;
+
+struct search_statistics_t {
+  unsigned long expanded;        // Configurations whose transitions were tried.
+  unsigned long memoHits;        // Configurations found among the passed points.
+  unsigned long memoMisses;
+  unsigned long loopPrunes;      // Hits that repeat a configuration of their own path.
+  unsigned long depthPrunes;     // Configurations deeper than the stack limit.
+  unsigned long epsilonPrunes;   // Transitions and configurations cut by the analysis of the e-transitions.
+  unsigned long firstPrunes;     // e-transitions that can't read the next symbol of the tape.
+  unsigned maxStackDepth;
+  unsigned long maxFrontier;     // Configurations kept to be expanded at the same time.
+  vector<unsigned long> fired;   // Times every transition was taken.
+  double seconds;
+};
+
+void resetStatistics (search_statistics_t& statistics, unsigned transitions);
+// The counters and the transitions taken the most.
+void showStatistics (ostream& out, const search_statistics_t& statistics, const vector<transition_t>& transitions);
+
+#endif
@@ -0,0 +1,66 @@
+#include "SharedStack.hpp"
+#include <algorithm>
+
+
+// Mix the fingerprint of the stack below with the pushed symbol (splitmix64 finalizer).
+fingerprint_t SharedStack::mix (fingerprint_t below, symbol_t symbol) {
+  fingerprint_t x = below + 0x9E3779B97F4A7C15ULL * (symbol + 1);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+SharedStack::SharedStack () {
+  clear();
+}
+
+SharedStack::~SharedStack () {}
+
+stack_ref SharedStack::push (stack_ref stack, symbol_t symbol, unsigned weight) {
+  stack_node node;
+  node.symbol = symbol;
+  node.below = stack;
+  node.size = nodes_[stack].size + 1;
+  node.weight = min(nodes_[stack].weight + weight, MAX_WEIGHT);
+  node.fingerprint = mix(nodes_[stack].fingerprint, symbol);
+  nodes_.push_back(node);
+  return nodes_.size() - 1;
+}
+
+void SharedStack::clear () {
+  stack_node bottom;
+  bottom.symbol = NO_SYMBOL;
+  bottom.below = EMPTY_STACK;
+  bottom.size = 0;
+  bottom.weight = 0;
+  bottom.fingerprint = EMPTY_FINGERPRINT;
+  nodes_.assign(1, bottom);
+}
+
+// The nodes below a node are always before it, so the ones kept stay in the same order and the index of
+// the node below is already known when a node is moved.
+void SharedStack::compact (vector<stack_ref>& stacks) {
+  vector<stack_ref> index (nodes_.size(), EMPTY_STACK);   // New index of every node kept.
+  for (unsigned i = 0; i < stacks.size(); i++)
+    for (stack_ref node = stacks[i]; node != EMPTY_STACK && index[node] == EMPTY_STACK; node = nodes_[node].below)
+      index[node] = node;
+  stack_ref kept = 1;
+  for (stack_ref node = 1; node < nodes_.size(); node++)
+    if (index[node] != EMPTY_STACK) {
+      stack_node moved = nodes_[node];
+      moved.below = index[moved.below];
+      nodes_[kept] = moved;
+      index[node] = kept++;
+    }
+  nodes_.resize(kept);
+  for (unsigned i = 0; i < stacks.size(); i++)
+    stacks[i] = index[stacks[i]];
+}
+
+// Symbols from the top to the bottom, like Stack::getStackLine.
+const string SharedStack::getStackLine (stack_ref stack, const SymbolTable& symbols) const {
+  string res;
+  for (stack_ref i = stack; i != EMPTY_STACK; i = nodes_[i].below)
+    res += symbols.name(nodes_[i].symbol);
+  return res;
+}
@@ -0,0 +1,57 @@
+/***
+* @description: Graph-structured stack shared by all the branches of the search. Every stack is a
+*               reference to its top node and nodes point to the node below, so branches share the
+*               common tail and push/pop never copy the parent stack.
+***/
+#ifndef _SHARED_STACK_HPP_
+#define _SHARED_STACK_HPP_
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+typedef unsigned stack_ref;   // Index of the top node of a stack.
+typedef unsigned long long fingerprint_t;
+
+const stack_ref EMPTY_STACK = 0;
+const fingerprint_t EMPTY_FINGERPRINT = 0x6A09E667F3BCC909ULL;
+const unsigned MAX_WEIGHT = 1u << 30;   // Weights add up to this at most, a stack that can't be emptied weighs it.
+
+struct stack_node {
+  symbol_t symbol;
+  stack_ref below;   // Rest of the stack.
+  unsigned size;     // Number of symbols from this node to the bottom.
+  unsigned weight;   // Input symbols the stack needs at least to be emptied (see EpsilonAnalysis).
+  fingerprint_t fingerprint;   // Hash of the whole stack, computed from the one below when pushing.
+};
+
+class SharedStack {
+  vector<stack_node> nodes_;   // nodes_[EMPTY_STACK] is the bottom of every stack.
+
+public:
+  SharedStack ();
+  ~SharedStack ();
+
+  stack_ref push (stack_ref stack, symbol_t symbol, unsigned weight = 0);
+  stack_ref pop (stack_ref stack) const { return nodes_[stack].below; };
+  symbol_t getTop (stack_ref stack) const { return stack == EMPTY_STACK ? NO_SYMBOL : nodes_[stack].symbol; };
+  unsigned getSize (stack_ref stack) const { return nodes_[stack].size; };
+  unsigned getWeight (stack_ref stack) const { return nodes_[stack].weight; };
+  fingerprint_t getFingerprint (stack_ref stack) const { return nodes_[stack].fingerprint; };
+
+  // Nodes created after a mark can be released once no stack built after the mark is used anymore
+  // (when the search backtracks).
+  unsigned mark () const { return nodes_.size(); };
+  void release (unsigned mark) { nodes_.resize(mark); };
+  unsigned getNodeCount () const { return nodes_.size(); };
+  void clear ();
+  void compact (vector<stack_ref>& stacks);   // Keep only the nodes of the stacks, which are renumbered.
+
+  const string getStackLine (stack_ref stack, const SymbolTable& symbols) const;
+
+  static fingerprint_t mix (fingerprint_t below, symbol_t symbol);   // Fingerprint after pushing the symbol.
+};
+
+#endif
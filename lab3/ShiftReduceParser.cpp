@@ -0,0 +1,83 @@
+#include "ShiftReduceParser.hpp"
+
+
+ShiftReduceParser::ShiftReduceParser (const LalrTable& table, const RunConfig& config)
+  : table_(table), config_(config) {
+  statistics_ = NULL;
+  moves_ = 0;
+  maxDepth_ = 0;
+  stopped_ = NO_BUDGET;
+  accepted_ = false;
+}
+
+ShiftReduceParser::~ShiftReduceParser () {}
+
+bool ShiftReduceParser::finish (bool accepted, budget_t stopped) {
+  accepted_ = accepted;
+  stopped_ = stopped;
+  if (statistics_ != NULL) {
+    statistics_->expanded += moves_;
+    statistics_->maxStackDepth = max(statistics_->maxStackDepth, maxDepth_);
+    statistics_->maxFrontier = max(statistics_->maxFrontier, 1ul);
+  }
+  return accepted_;
+}
+
+bool ShiftReduceParser::run (const vector<symbol_t>& tape) {
+  VectorTape vectorTape (tape);
+  return runTape(vectorTape);
+}
+
+bool ShiftReduceParser::run (TapeStream& tape) {
+  return runTape(tape);
+}
+
+// The stack of states is not the stack of the automaton, so the depth limit doesn't apply to it; the
+// other budgets are checked like in the deterministic run. A symbol out of the grammar is an error.
+template <class Tape>
+bool ShiftReduceParser::runTape (Tape& tape) {
+  const vector<production_t>& productions = table_.getGrammar().getProductions();
+  states_.assign(1, 0);
+  moves_ = 0;
+  maxDepth_ = 1;
+  chrono::steady_clock::time_point deadline = config_.startDeadline();
+
+  unsigned long pos = 0;
+  while (true) {
+    if (moves_ >= config_.getMaxConfigurations())
+      return finish(false, CONFIGURATION_BUDGET);
+    if (moves_ % 4096 == 0) {
+      if (states_.size() * sizeof(unsigned) > config_.getMaxMemory())
+        return finish(false, MEMORY_BUDGET);
+      if (chrono::steady_clock::now() > deadline)
+        return finish(false, TIME_BUDGET);
+    }
+
+    symbol_t symbol = tape.hasNext(pos) ? tape.getSymbol(pos) : table_.getEnd();
+    if (symbol > table_.getEnd())
+      return finish(false, NO_BUDGET);
+    const lr_entry_t& entry = table_.getAction(states_.back(), symbol);
+    moves_++;
+    switch (entry.action) {
+      case LR_SHIFT:
+        states_.push_back(entry.target);
+        maxDepth_ = max(maxDepth_, (unsigned) states_.size());
+        tape.release(++pos);
+        break;
+      case LR_REDUCE: {
+        const production_t& production = productions[entry.target];
+        states_.resize(states_.size() - production.rhs.size());
+        int next = table_.getGoto(states_.back(), production.lhs);
+        if (next < 0)
+          return finish(false, NO_BUDGET);
+        states_.push_back(next);
+        maxDepth_ = max(maxDepth_, (unsigned) states_.size());
+        break;
+      }
+      case LR_ACCEPT:
+        return finish(true, NO_BUDGET);
+      default:
+        return finish(false, NO_BUDGET);
+    }
+  }
+}
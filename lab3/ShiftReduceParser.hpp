@@ -0,0 +1,42 @@
+/***
+* @description: Table-driven shift-reduce parser over an LALR(1) table without conflicts. Every symbol is
+*               read once and there is nothing to go back to, so the input is checked in linear time with
+*               memory proportional to the stack of states, and a TapeStream can be checked while it arrives.
+***/
+#ifndef _SHIFT_REDUCE_PARSER_HPP_
+#define _SHIFT_REDUCE_PARSER_HPP_
+#include <vector>
+#include "LalrTable.hpp"
+#include "RunConfig.hpp"
+#include "TapeStream.hpp"
+#include "SearchStatistics.hpp"
+
+using namespace std;
+
+class ShiftReduceParser {
+  const LalrTable& table_;
+  const RunConfig& config_;
+  search_statistics_t* statistics_;   // Counters of the parse, updated when it is not NULL.
+  vector<unsigned> states_;           // Stack of states, bottom first.
+  unsigned long moves_;               // Shifts and reductions.
+  unsigned maxDepth_;
+  budget_t stopped_;
+  bool accepted_;
+
+public:
+  ShiftReduceParser (const LalrTable& table, const RunConfig& config);
+  ~ShiftReduceParser ();
+
+  void setStatistics (search_statistics_t* statistics) { statistics_ = statistics; };
+  bool run (const vector<symbol_t>& tape);
+  bool run (TapeStream& tape);
+  check_result_t getResult () const { return makeResult(accepted_, stopped_, false); };
+  unsigned long getMoves () const { return moves_; };
+  unsigned getMaxDepth () const { return maxDepth_; };
+
+private:
+  template <class Tape> bool runTape (Tape& tape);
+  bool finish (bool accepted, budget_t stopped);
+};
+
+#endif
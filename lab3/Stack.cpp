@@ -1,84 +1,89 @@
 #include "Stack.hpp"
-#include <algorithm>
 
 
-Stack::Stack (vector<string> aSymbols) {
-	acceptedSymbols = aSymbols;
+Stack::Stack (const SymbolTable& symbols, unsigned alphabetSize) {
+	symbols_ = &symbols;
+	alphabetSize_ = alphabetSize;
 	sz = 0;
+	initialSymbol = NO_SYMBOL;
 }
 
 Stack::~Stack () { }
 
 
-void Stack::push (string symbol) {
-  if (find(acceptedSymbols.begin(), acceptedSymbols.end(), symbol) != acceptedSymbols.end()) {
-		if (getSize() == 0) initialSymbol = symbol;
-		content.push_back(symbol);
-		sz++;
-	}
+bool Stack::push (symbol_t symbol) {
+	if (!isAccepted(symbol))
+		return false;
+	if (sz == 0)
+		initialSymbol = symbol;
+	if (sz < STACK_INLINE_SYMBOLS)
+		bottom_[sz] = symbol;
 	else
-		cout << "The symbol " << symbol << " is not contained in the stack alphabet" << endl;
+		rest_.push_back(symbol);
+	sz++;
+	return true;
 }
 
-void Stack::push (vector<string> symbols) {
-	for (int i = 0; i < symbols.size(); i++) {
-		push(symbols[symbols.size() - 1 - i]);
-	}
+void Stack::push (const vector<symbol_t>& symbols) {
+	for (unsigned i = symbols.size(); i > 0; i--)
+		push(symbols[i - 1]);
 }
 
-string Stack::pop () {
-	if (sz > 0) {
-		string last = content.back();
-		content.pop_back();
-		sz--;
-		return last;
-	}
-	return "";
+void Stack::push (string symbol) {
+	if (!push(symbols_->find(symbol)))
+		cout << "The symbol " << symbol << " is not contained in the stack alphabet" << endl;
 }
 
-string Stack::getTop () {
-	if (!content.size())
-		return "";
-
-	return content.back();
+symbol_t Stack::pop () {
+	if (sz == 0)
+		return NO_SYMBOL;
+	symbol_t last = getTop();
+	if (sz > STACK_INLINE_SYMBOLS)
+		rest_.pop_back();
+	sz--;
+	return last;
 }
 
-const unsigned Stack::getSize () {
-  return sz;
+symbol_t Stack::getTop () const {
+	if (sz == 0)
+		return NO_SYMBOL;
+	return at(sz - 1);
 }
 
-const string Stack::getInitialSymbol () {
-	return initialSymbol;
+const string Stack::getInitialSymbolName () const {
+	if (initialSymbol == NO_SYMBOL)
+		return "";
+	return symbols_->name(initialSymbol);
 }
 
-const vector<string> Stack::getAcceptedSymbols () {
-	return acceptedSymbols;
+// The declared symbols are the first ids of the table, without repetitions.
+const vector<string> Stack::getAcceptedSymbols () const {
+	vector<string> res;
+	for (symbol_t id = 0; id < alphabetSize_; id++)
+		res.push_back(symbols_->name(id));
+	return res;
 }
 
-const string Stack::getStackLine() {
+const string Stack::getStackLine () const {
 	string res;
-
-	for (int i = 0; i < content.size(); i++) {
-		res += content.at(content.size() - i - 1);
-	}
-
+	for (unsigned i = sz; i > 0; i--)
+		res += symbols_->name(at(i - 1));
 	return res;
 }
 
 
-const void Stack::show () {
+const void Stack::show () const {
 	cout << endl << "TOP" << endl;
- 	for (int i = 0; i < getSize(); i++)
-		if (i < getSize() - 1)
-	  		cout << "    | " << content.at(getSize() - i - 1) << " |" << endl;
+	for (unsigned i = sz; i > 0; i--)
+		if (i > 1)
+			cout << "    | " << symbols_->name(at(i - 1)) << " |" << endl;
 		else
-	                cout << "    |_" << content.at(getSize() - i - 1) << "_|" << endl;
-	cout  << endl;
+			cout << "    |_" << symbols_->name(at(i - 1)) << "_|" << endl;
+	cout << endl;
 }
 
 
-const void Stack::showInline () {
-	for (int i = 0; i < getSize(); i++) {
-		cout << content.at(getSize() - i - 1);
-	}
+const void Stack::showInline () const {
+	for (unsigned i = sz; i > 0; i--)
+		cout << symbols_->name(at(i - 1));
 }
@@ -4,38 +4,50 @@
 * @subject: Complejidad computacional at Universidad de La Laguna
 * @year: 2016
 * @description: Stack class used for the Automaton to push and pop characters depending on the transition functions.
-*
+*               It keeps the interned ids of the symbols, the first ones inside the object itself, and shares
+*               the names with the automaton instead of copying its alphabet.
 ***/
 #ifndef _STACK_HPP
 #define _STACK_HPP
 #include <iostream>
 #include <string>
 #include <vector>
+#include "SymbolTable.hpp"
 
 using namespace std;
 
+const unsigned STACK_INLINE_SYMBOLS = 16;   // Symbols kept in the object before the rest goes to the heap.
+
 class Stack {
-  vector<string> acceptedSymbols;  // Símbolos que acepta la pila.
-  vector<string> content; // Contenido de la pila.
+  const SymbolTable* symbols_;   // Names of the ids, owned by the automaton.
+  unsigned alphabetSize_;        // The ids below it are the stack alphabet.
   unsigned sz;
-  string initialSymbol;
+  symbol_t initialSymbol;
+  symbol_t bottom_[STACK_INLINE_SYMBOLS];   // First symbols pushed.
+  vector<symbol_t> rest_;                   // Symbols above them.
 
 public:
-  Stack (vector<string> aSymbols);
+  Stack (const SymbolTable& symbols, unsigned alphabetSize);
   ~Stack ();
 
+  bool isAccepted (symbol_t symbol) const { return symbol < alphabetSize_; };
+  bool push (symbol_t symbol);                   // False if the symbol is not in the stack alphabet.
+  void push (const vector<symbol_t>& symbols);   // The first one ends on top.
   void push (string symbol);
-  void push (vector<string> symbols);
-  string pop ();
-  string getTop ();
-  const void show ();        // show content more beautiful.
-  const void showInline ();  // show content in the trace table.
+  symbol_t pop ();                               // NO_SYMBOL if the stack is empty.
+  symbol_t getTop () const;
+  const void show () const;        // show content more beautiful.
+  const void showInline () const;  // show content in the trace table.
 
   // Getters
-  const unsigned getSize();
-  const string getInitialSymbol ();
-  const vector<string> getAcceptedSymbols ();
-  const string getStackLine();
+  const unsigned getSize () const { return sz; };
+  const symbol_t getInitialSymbol () const { return initialSymbol; };   // NO_SYMBOL if nothing was pushed.
+  const string getInitialSymbolName () const;
+  const vector<string> getAcceptedSymbols () const;
+  const string getStackLine () const;
+
+private:
+  symbol_t at (unsigned i) const { return i < STACK_INLINE_SYMBOLS ? bottom_[i] : rest_[i - STACK_INLINE_SYMBOLS]; };
 };
 
 #endif
@@ -0,0 +1,29 @@
+#include "SymbolTable.hpp"
+
+
+SymbolTable::SymbolTable () {}
+
+SymbolTable::~SymbolTable () {}
+
+symbol_t SymbolTable::intern (const string& name) {
+  auto it = ids_.find(name);
+  if (it != ids_.end())
+    return it->second;
+
+  symbol_t id = names_.size();
+  names_.push_back(name);
+  ids_[name] = id;
+  return id;
+}
+
+symbol_t SymbolTable::find (const string& name) const {
+  auto it = ids_.find(name);
+  if (it == ids_.end())
+    return NO_SYMBOL;
+  return it->second;
+}
+
+void SymbolTable::clear () {
+  names_.clear();
+  ids_.clear();
+}
@@ -0,0 +1,32 @@
+/***
+* @description: Symbol table that interns the names of states and symbols into small integer ids,
+*               so the automaton can index its transitions instead of comparing strings.
+***/
+#ifndef _SYMBOL_TABLE_HPP_
+#define _SYMBOL_TABLE_HPP_
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+typedef unsigned symbol_t;
+
+const symbol_t NO_SYMBOL = ~0u;   // Returned when a name was never interned.
+
+class SymbolTable {
+  vector<string> names_;                  // id -> name
+  unordered_map<string, symbol_t> ids_;   // name -> id
+
+public:
+  SymbolTable ();
+  ~SymbolTable ();
+
+  symbol_t intern (const string& name);     // Return the id of the name, adding it if it is new.
+  symbol_t find (const string& name) const; // Return the id of the name or NO_SYMBOL.
+  const string& name (symbol_t id) const { return names_[id]; };
+  unsigned size () const { return names_.size(); };
+  void clear ();
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "TapeStream.hpp"
+#include "TransitionTable.hpp"
+#include <cctype>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+TapeStream::TapeStream (const SymbolTable& inputSymbols)
+  : inputSymbols_(inputSymbols), tokenizer_(inputSymbols, inputSymbols.size()) {
+  fd_ = -1;
+  chunk_.resize(TAPE_CHUNK_SIZE);
+  chunkPos_ = 0;
+  chunkEnd_ = 0;
+  wordEnded_ = false;
+  ended_ = true;
+  base_ = 0;
+  peakWindow_ = 0;
+}
+
+TapeStream::~TapeStream () {
+  if (fd_ > 0)
+    close(fd_);
+}
+
+bool TapeStream::open (string fileName) {
+  fileName_ = fileName;
+  fd_ = fileName == "-" ? 0 : ::open(fileName.c_str(), O_RDONLY);
+  ended_ = fd_ < 0;
+  if (fd_ > 0)
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  return fd_ >= 0;
+}
+
+bool TapeStream::hasNext (unsigned long pos) {
+  while (pos >= getRead())
+    if (!readSymbol())
+      return false;
+  return true;
+}
+
+void TapeStream::release (unsigned long pos) {
+  while (base_ < pos && !window_.empty()) {
+    window_.pop_front();
+    base_++;
+  }
+}
+
+// Like the tape of an input file, an "e" can only be followed by e-transitions. The symbol at the
+// beginning of the word is cut once the longest symbol fits in partial_ or the word ends.
+bool TapeStream::readSymbol () {
+  while (partial_.size() < tokenizer_.getMaxLength() && !wordEnded_) {
+    if (chunkPos_ == chunkEnd_ && !fillChunk())
+      wordEnded_ = true;
+    else {
+      char c = chunk_[chunkPos_++];
+      if (!isspace((unsigned char) c))
+        partial_ += c;
+      else
+        wordEnded_ = !partial_.empty();
+    }
+  }
+  if (partial_.empty())
+    return false;
+
+  size_t length = tokenizer_.match(partial_);
+  symbol_t symbol = inputSymbols_.find(partial_.substr(0, length));
+  window_.push_back(symbol == EPSILON ? NO_SYMBOL : symbol);
+  peakWindow_ = max(peakWindow_, (unsigned long) window_.size());
+  partial_.erase(0, length);
+  if (partial_.empty())
+    wordEnded_ = false;
+  return true;
+}
+
+bool TapeStream::fillChunk () {
+  if (ended_)
+    return false;
+  ssize_t bytes;
+  do
+    bytes = read(fd_, &chunk_[0], chunk_.size());
+  while (bytes < 0 && errno == EINTR);
+  if (bytes <= 0) {
+    ended_ = true;
+    return false;
+  }
+  chunkPos_ = 0;
+  chunkEnd_ = bytes;
+  return true;
+}
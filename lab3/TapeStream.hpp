@@ -0,0 +1,69 @@
+/***
+* @description: Input tape read from a file or a pipe while it is checked. The text is split into symbols
+*               by the tokenizer like an input file; it is read in chunks, the symbols are looked up as input
+*               ids and kept only from the first position that can still be read, so the input can be
+*               larger than memory.
+***/
+#ifndef _TAPE_STREAM_HPP_
+#define _TAPE_STREAM_HPP_
+#include <string>
+#include <vector>
+#include <deque>
+#include "SymbolTable.hpp"
+#include "Tokenizer.hpp"
+
+using namespace std;
+
+const unsigned TAPE_CHUNK_SIZE = 1 << 16;   // Bytes read from the file at once.
+// Symbols a check reads ahead to cut the stacks that need more input than what is left, the heavier
+// ones are kept.
+const unsigned TAPE_LOOKAHEAD = 1 << 16;
+
+class TapeStream {
+  const SymbolTable& inputSymbols_;
+  Tokenizer tokenizer_;
+  string fileName_;              // "-" for the standard input.
+  int fd_;
+  vector<char> chunk_;
+  unsigned chunkPos_;
+  unsigned chunkEnd_;
+  string partial_;               // Characters of the word not split yet, up to the longest symbol.
+  bool wordEnded_;               // No more characters of the word in partial_ follow.
+  bool ended_;
+
+  deque<symbol_t> window_;       // Symbols from base_ on.
+  unsigned long base_;
+  unsigned long peakWindow_;
+
+public:
+  TapeStream (const SymbolTable& inputSymbols);
+  ~TapeStream ();
+
+  bool open (string fileName);   // "-" reads the standard input.
+
+  // True if there is a symbol at the position, reading the input up to it. It can't be before the window.
+  bool hasNext (unsigned long pos);
+  symbol_t getSymbol (unsigned long pos) const { return window_[pos - base_]; };   // After hasNext.
+  void release (unsigned long pos);   // The positions before it won't be read again.
+
+  unsigned long getRead () const { return base_ + window_.size(); };   // Symbols read from the input.
+  unsigned long getLookahead () const { return TAPE_LOOKAHEAD; };
+  unsigned long getPeakWindow () const { return peakWindow_; };
+
+private:
+  bool readSymbol ();   // Add the next symbol to the window, false at the end of the input.
+  bool fillChunk ();
+};
+
+// Tape in memory with the interface of TapeStream, for the runners that read the input once.
+class VectorTape {
+  const vector<symbol_t>& tape_;
+public:
+  VectorTape (const vector<symbol_t>& tape) : tape_(tape) {}
+  bool hasNext (unsigned long pos) { return pos < tape_.size(); };
+  symbol_t getSymbol (unsigned long pos) const { return tape_[pos]; };
+  void release (unsigned long pos) {}
+  unsigned long getLookahead () const { return tape_.size(); };
+};
+
+#endif
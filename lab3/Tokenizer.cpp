@@ -0,0 +1,38 @@
+#include "Tokenizer.hpp"
+
+
+Tokenizer::Tokenizer (const SymbolTable& symbols, unsigned alphabetSize) : symbols_(symbols) {
+  alphabetSize_ = min(alphabetSize, symbols_.size());
+  maxLength_ = 1;
+  for (symbol_t id = 0; id < alphabetSize_; id++)
+    maxLength_ = max(maxLength_, (unsigned) symbols_.name(id).size());
+}
+
+Tokenizer::~Tokenizer () {}
+
+bool Tokenizer::isSymbol (string_view token) const {
+  return symbols_.find(string(token)) < alphabetSize_;
+}
+
+size_t Tokenizer::match (string_view word) const {
+  size_t length = min((size_t) maxLength_, word.size());
+  while (length > 1 && !isSymbol(word.substr(0, length)))
+    length--;
+  return length;
+}
+
+void Tokenizer::split (string_view text, vector<string_view>& tokens) const {
+  tokens.clear();
+  const string_view BLANKS = " \t\r\n";
+  size_t pos = text.find_first_not_of(BLANKS);
+  while (pos != string_view::npos) {
+    size_t end = text.find_first_of(BLANKS, pos);
+    string_view word = text.substr(pos, end == string_view::npos ? string_view::npos : end - pos);
+    for (size_t i = 0; i < word.size(); ) {
+      size_t length = match(word.substr(i));
+      tokens.push_back(word.substr(i, length));
+      i += length;
+    }
+    pos = end == string_view::npos ? end : text.find_first_not_of(BLANKS, end);
+  }
+}
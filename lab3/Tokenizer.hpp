@@ -0,0 +1,33 @@
+/***
+* @description: Splits a text into the symbols of an alphabet, so symbols can have more than one
+*               character. Blanks separate symbols, and a word without blanks is split into the longest
+*               symbols of the alphabet from its beginning. The symbols are views into the text.
+***/
+#ifndef _TOKENIZER_HPP_
+#define _TOKENIZER_HPP_
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+class Tokenizer {
+  const SymbolTable& symbols_;
+  unsigned alphabetSize_;   // Only the first ids of the table are symbols of the alphabet.
+  unsigned maxLength_;      // Characters of the longest symbol.
+
+public:
+  Tokenizer (const SymbolTable& symbols, unsigned alphabetSize);
+  ~Tokenizer ();
+
+  // A character that begins no symbol is a symbol of its own, so it is rejected by the automaton.
+  void split (string_view text, vector<string_view>& tokens) const;
+  // Characters of the symbol the word begins with. It only depends on the first getMaxLength() characters,
+  // so a word can be split while it is read.
+  size_t match (string_view word) const;
+  bool isSymbol (string_view token) const;
+  unsigned getMaxLength () const { return maxLength_; };
+};
+
+#endif
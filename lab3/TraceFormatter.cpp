@@ -0,0 +1,259 @@
+#include "TraceFormatter.hpp"
+#include "RunConfig.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+
+const unsigned UNKNOWN_NODE = ~0u;   // Node whose record was dropped by the ring buffer.
+
+// Quoted JSON string.
+static string jsonString (const string& value) {
+  ostringstream res;
+  res << '"';
+  for (unsigned i = 0; i < value.size(); i++) {
+    unsigned char c = value[i];
+    if (c == '"' || c == '\\')
+      res << '\\' << c;
+    else if (c < 0x20)
+      res << "\\u" << hex << setw(4) << setfill('0') << (unsigned) c << dec;
+    else
+      res << c;
+  }
+  res << '"';
+  return res.str();
+}
+
+static bool getUnsigned (istream& in, unsigned& value) {
+  return (bool) in.read((char*) &value, sizeof(value));
+}
+
+static bool getString (istream& in, string& value) {
+  unsigned size;
+  if (!getUnsigned(in, size))
+    return false;
+  value.resize(size);
+  return size == 0 || in.read(&value[0], size);
+}
+
+
+TraceFormatter::TraceFormatter () {
+  dropped_ = 0;
+}
+
+TraceFormatter::~TraceFormatter () {}
+
+bool TraceFormatter::load (string fileName) {
+  ifstream file (fileName.c_str(), ios::binary);
+  if (!file.is_open() || !readPrologue(file))
+    return false;
+  trace_record_t record;
+  records_.clear();
+  while (file.read((char*) &record, sizeof(record)))
+    records_.push_back(record);
+  dropped_ = 0;
+  return true;
+}
+
+bool TraceFormatter::load (const TraceSink& sink) {
+  istringstream prologue (sink.getPrologue());
+  if (!readPrologue(prologue))
+    return false;
+  records_ = sink.getRecords();
+  dropped_ = sink.getDropped();
+  return true;
+}
+
+bool TraceFormatter::readPrologue (istream& in) {
+  char magic[sizeof(TRACE_MAGIC)];
+  unsigned version;
+  if (!in.read(magic, sizeof(magic)) || memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+      !getUnsigned(in, version) || version != TRACE_VERSION)
+    return false;
+
+  vector<string>* tables[] = { &states_, &inputSymbols_, &stackSymbols_ };
+  unsigned size;
+  for (unsigned t = 0; t < 3; t++) {
+    if (!getUnsigned(in, size))
+      return false;
+    tables[t]->resize(size);
+    for (unsigned i = 0; i < size; i++)
+      if (!getString(in, (*tables[t])[i]))
+        return false;
+  }
+
+  if (!getUnsigned(in, size))
+    return false;
+  transitions_.resize(size);
+  from_.assign(states_.size() * stackSymbols_.size(), vector<unsigned>());
+  for (unsigned i = 0; i < size; i++) {
+    trace_transition_t& transition = transitions_[i];
+    if (!getUnsigned(in, transition.state) || !getUnsigned(in, transition.input) ||
+        !getUnsigned(in, transition.top) || !getString(in, transition.next) ||
+        transition.state >= states_.size() || transition.top >= stackSymbols_.size())
+      return false;
+    from_[transition.state * stackSymbols_.size() + transition.top].push_back(i);
+  }
+
+  if (!getUnsigned(in, size))
+    return false;
+  tape_.resize(size);
+  tapeIds_.resize(size);
+  for (unsigned i = 0; i < size; i++)
+    if (!getString(in, tape_[i]) || !getUnsigned(in, tapeIds_[i]))
+      return false;
+  return true;
+}
+
+// Same table as the trace of the search used to print while it was running.
+void TraceFormatter::showTable (ostream& out) const {
+  out << "---- State ---- ---- Input ---- ---- Stack ---- ---- Actions ----" << endl;
+  if (dropped_ > 0)
+    out << "(" << dropped_ << " earlier records were dropped)" << endl;
+
+  vector<trace_node_t> nodes (1);
+  nodes[0].below = UNKNOWN_NODE;
+  bool accepted = false;
+  for (unsigned r = 0; r < records_.size(); r++) {
+    const trace_record_t& record = records_[r];
+    switch (record.event) {
+      case NODE_EVENT:
+        replayNode(nodes, record);
+        break;
+      case ACCEPT_EVENT:
+        accepted = true;
+        break;
+      case CONFIGURATION_EVENT: {
+        if (record.a >= states_.size())
+          break;
+        out << setw(8) << states_[record.a];
+        if (record.b < tape_.size())
+          out << setw(14) << tape_[record.b] << getInput(record.b + 1) << "$";
+        else
+          out << setw(14) << "$";
+        string stackLine = getStackLine(nodes, record.c);
+        if (stackLine != "") {
+          // The first symbol is the one padded.
+          symbol_t top = getTop(nodes, record.c);
+          string topName = top == NO_SYMBOL ? "?" : stackSymbols_[top];
+          out << setw(14) << topName << stackLine.substr(topName.size());
+        }
+
+        vector<unsigned> allowed = getAllowedTransitions(record.a, record.b, getTop(nodes, record.c));
+        if (allowed.size() > 0) {
+          out << setw(14) << transitions_[allowed[0]].next;
+          for (unsigned i = 1; i < allowed.size(); i++)
+            out << ", " << transitions_[allowed[i]].next;
+          out << endl;
+        }
+        else {
+          out << setw(14) << "         NO TRANSITIONS ALLOWED.." << endl;
+          if (!accepted)
+            out << "STRING IS NOT PASSED CURRENT PATH.." << endl;
+          else
+            out << "STRING IS SUCCESSFULLY PASSED.." << endl;
+          out << "==========================================================================" << endl;
+        }
+        break;
+      }
+      case LOOP_EVENT:
+        out << "Loop detected, " << getStackLine(nodes, record.c) << ", " << getInput(record.b) << " skip" << endl;
+        break;
+      case DEPTH_LIMIT_EVENT:
+        out << "End limit" << endl;
+        break;
+      case BUDGET_EVENT:
+        out << "Budget exhausted: " << RunConfig::getBudgetName((budget_t) record.a) << endl;
+        break;
+    }
+  }
+}
+
+// One object per event, stack nodes are only used to fill the stacks.
+void TraceFormatter::showJson (ostream& out) const {
+  const char* names[] = { "node", "configuration", "accept", "loop", "depth_limit", "budget" };
+  out << "{\"dropped\": " << dropped_ << ", \"events\": [";
+
+  vector<trace_node_t> nodes (1);
+  nodes[0].below = UNKNOWN_NODE;
+  bool first = true;
+  for (unsigned r = 0; r < records_.size(); r++) {
+    const trace_record_t& record = records_[r];
+    if (record.event == NODE_EVENT) {
+      replayNode(nodes, record);
+      continue;
+    }
+    if (record.event > BUDGET_EVENT)
+      continue;
+
+    out << (first ? "\n  " : ",\n  ") << "{\"event\": " << jsonString(names[record.event]);
+    first = false;
+    if (record.event == BUDGET_EVENT)
+      out << ", \"budget\": " << jsonString(RunConfig::getBudgetName((budget_t) record.a));
+    else if (record.a < states_.size()) {
+      out << ", \"state\": " << jsonString(states_[record.a]) << ", \"input\": " << jsonString(getInput(record.b))
+          << ", \"stack\": " << jsonString(getStackLine(nodes, record.c));
+      if (record.event == CONFIGURATION_EVENT) {
+        vector<unsigned> allowed = getAllowedTransitions(record.a, record.b, getTop(nodes, record.c));
+        out << ", \"transitions\": [";
+        for (unsigned i = 0; i < allowed.size(); i++)
+          out << (i > 0 ? ", " : "") << jsonString(transitions_[allowed[i]].next);
+        out << "]";
+      }
+    }
+    out << "}";
+  }
+  out << "\n]}" << endl;
+}
+
+// Transitions that read the symbol at the position or nothing, in file order like the search tries them.
+vector<unsigned> TraceFormatter::getAllowedTransitions (symbol_t state, unsigned pos, symbol_t top) const {
+  vector<unsigned> allowed;
+  if (state >= states_.size() || top >= stackSymbols_.size())
+    return allowed;
+  symbol_t symbol = pos < tapeIds_.size() ? tapeIds_[pos] : NO_SYMBOL;
+  const vector<unsigned>& candidates = from_[state * stackSymbols_.size() + top];
+  for (unsigned i = 0; i < candidates.size(); i++) {
+    symbol_t input = transitions_[candidates[i]].input;
+    if (input == EPSILON || input == symbol)
+      allowed.push_back(candidates[i]);
+  }
+  return allowed;
+}
+
+// Node ids are reused once the search backtracks, the last record of a node is the one in use.
+void TraceFormatter::replayNode (vector<trace_node_t>& nodes, const trace_record_t& record) const {
+  if (record.a == 0)
+    return;
+  if (record.a >= nodes.size()) {
+    trace_node_t unknown;
+    unknown.symbol = NO_SYMBOL;
+    unknown.below = UNKNOWN_NODE;
+    nodes.resize(record.a + 1, unknown);
+  }
+  nodes[record.a].symbol = record.b;
+  nodes[record.a].below = record.c;
+}
+
+string TraceFormatter::getStackLine (const vector<trace_node_t>& nodes, unsigned stack) const {
+  string res;
+  for (unsigned i = stack; i != 0; i = nodes[i].below) {
+    if (i >= nodes.size() || nodes[i].below == UNKNOWN_NODE || nodes[i].symbol >= stackSymbols_.size())
+      return res + "?";
+    res += stackSymbols_[nodes[i].symbol];
+  }
+  return res;
+}
+
+symbol_t TraceFormatter::getTop (const vector<trace_node_t>& nodes, unsigned stack) const {
+  if (stack == 0 || stack >= nodes.size())
+    return NO_SYMBOL;
+  return nodes[stack].symbol;
+}
+
+string TraceFormatter::getInput (unsigned pos) const {
+  string res;
+  for (unsigned i = pos; i < tape_.size(); i++)
+    res += tape_[i];
+  return res;
+}
@@ -0,0 +1,56 @@
+/***
+* @description: Renders the records of a TraceSink, from a trace file or from memory, as the trace table
+*               of the automaton or as JSON.
+***/
+#ifndef _TRACE_FORMATTER_HPP_
+#define _TRACE_FORMATTER_HPP_
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+#include "TransitionTable.hpp"
+#include "TraceSink.hpp"
+
+using namespace std;
+
+class TraceFormatter {
+  struct trace_transition_t {
+    symbol_t state;
+    symbol_t input;
+    symbol_t top;
+    string next;
+  };
+  struct trace_node_t {
+    symbol_t symbol;
+    unsigned below;
+  };
+
+  vector<string> states_;
+  vector<string> inputSymbols_;
+  vector<string> stackSymbols_;
+  vector<trace_transition_t> transitions_;
+  vector<vector<unsigned> > from_;   // Transitions by (state, top), in file order.
+  vector<string> tape_;
+  vector<symbol_t> tapeIds_;
+  vector<trace_record_t> records_;
+  unsigned long long dropped_;   // Records the ring buffer overwrote before they were rendered.
+
+public:
+  TraceFormatter ();
+  ~TraceFormatter ();
+
+  bool load (string fileName);
+  bool load (const TraceSink& sink);
+  void showTable (ostream& out) const;
+  void showJson (ostream& out) const;
+
+private:
+  bool readPrologue (istream& in);
+  vector<unsigned> getAllowedTransitions (symbol_t state, unsigned pos, symbol_t top) const;
+  void replayNode (vector<trace_node_t>& nodes, const trace_record_t& record) const;
+  string getStackLine (const vector<trace_node_t>& nodes, unsigned stack) const;
+  symbol_t getTop (const vector<trace_node_t>& nodes, unsigned stack) const;
+  string getInput (unsigned pos) const;
+};
+
+#endif
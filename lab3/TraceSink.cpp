@@ -0,0 +1,92 @@
+#include "TraceSink.hpp"
+#include "PushDownAutomaton.hpp"
+
+
+TraceSink::TraceSink (string fileName) {
+  fileName_ = fileName;
+  if (isInMemory())
+    buffer_.resize(TRACE_RING_RECORDS);
+  else {
+    file_.open(fileName_.c_str(), ios::binary | ios::trunc);
+    buffer_.resize(TRACE_BLOCK_RECORDS);
+  }
+  next_ = 0;
+  wrapped_ = false;
+  recorded_ = 0;
+}
+
+TraceSink::~TraceSink () {
+  flush();
+}
+
+void TraceSink::begin (const PushDownAutomaton& automaton, const vector<string>& tape, const vector<symbol_t>& tapeIds) {
+  prologue_.assign(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+  putUnsigned(TRACE_VERSION);
+
+  const SymbolTable* tables[] = { &automaton.getStates(), &automaton.getInputSymbols(), &automaton.getStackSymbols() };
+  for (unsigned t = 0; t < 3; t++) {
+    putUnsigned(tables[t]->size());
+    for (symbol_t id = 0; id < tables[t]->size(); id++)
+      putString(tables[t]->name(id));
+  }
+
+  const vector<transition_t>& transitions = automaton.getTransitions();
+  putUnsigned(transitions.size());
+  for (unsigned i = 0; i < transitions.size(); i++) {
+    putUnsigned(transitions[i].state);
+    putUnsigned(transitions[i].input);
+    putUnsigned(transitions[i].top);
+    putString(transitions[i].next);
+  }
+
+  putUnsigned(tape.size());
+  for (unsigned i = 0; i < tape.size(); i++) {
+    putString(tape[i]);
+    putUnsigned(tapeIds[i]);
+  }
+
+  if (!isInMemory())
+    file_.write(prologue_.data(), prologue_.size());
+}
+
+void TraceSink::flush () {
+  if (!isInMemory() && next_ > 0) {
+    file_.write((const char*) buffer_.data(), next_ * sizeof(trace_record_t));
+    next_ = 0;
+  }
+  if (!isInMemory())
+    file_.flush();
+}
+
+// A full file buffer goes to the file, a full ring buffer starts again from the oldest record.
+void TraceSink::wrap () {
+  if (isInMemory()) {
+    next_ = 0;
+    wrapped_ = true;
+  }
+  else
+    flush();
+}
+
+vector<trace_record_t> TraceSink::getRecords () const {
+  if (!isInMemory())
+    return vector<trace_record_t>();
+  vector<trace_record_t> records;
+  if (wrapped_)
+    records.assign(buffer_.begin() + next_, buffer_.end());
+  records.insert(records.end(), buffer_.begin(), buffer_.begin() + next_);
+  return records;
+}
+
+unsigned long long TraceSink::getDropped () const {
+  return wrapped_ ? recorded_ - buffer_.size() : 0;
+}
+
+void TraceSink::putUnsigned (unsigned value) {
+  prologue_.append((const char*) &value, sizeof(value));
+}
+
+void TraceSink::putString (const string& value) {
+  putUnsigned(value.size());
+  prologue_ += value;
+}
@@ -0,0 +1,79 @@
+/***
+* @description: Trace of a search as fixed size binary records. The records are written to a file in big
+*               blocks or kept in a ring buffer in memory, and TraceFormatter renders them afterwards.
+*               The names needed to render them are written once at the beginning (the prologue).
+***/
+#ifndef _TRACE_SINK_HPP_
+#define _TRACE_SINK_HPP_
+#include <fstream>
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+class PushDownAutomaton;
+
+const char TRACE_MAGIC[8] = { 'P', 'D', 'A', 'T', 'R', 'A', 'C', 'E' };
+const unsigned TRACE_VERSION = 2;
+const unsigned TRACE_RING_RECORDS = 1 << 20;   // Records kept in memory when there is no trace file.
+const unsigned TRACE_BLOCK_RECORDS = 1 << 12;  // Records written to the file at once.
+
+enum trace_event_t {
+  NODE_EVENT,                 // a: stack node, b: symbol, c: node below.
+  CONFIGURATION_EVENT,        // a: state, b: tape position, c: stack node. The search arrives to it.
+  ACCEPT_EVENT,               // Same fields, the configuration accepts the input.
+  LOOP_EVENT,                 // Same fields, the configuration was already passed.
+  DEPTH_LIMIT_EVENT,          // Same fields, the stack is deeper than the limit.
+  BUDGET_EVENT                // a: budget_t that ran out and stopped the search.
+};
+
+struct trace_record_t {
+  unsigned event;
+  unsigned a;
+  unsigned b;
+  unsigned c;
+};
+
+class TraceSink {
+  string fileName_;               // Empty when the records are kept in memory.
+  ofstream file_;
+  string prologue_;
+  vector<trace_record_t> buffer_;
+  unsigned next_;                 // Position of the next record in buffer_.
+  bool wrapped_;                  // The ring buffer has overwritten old records.
+  unsigned long long recorded_;
+
+public:
+  TraceSink (string fileName);   // An empty name keeps the last TRACE_RING_RECORDS records in memory.
+  ~TraceSink ();
+
+  // Write the prologue: names of the automaton, its transitions and the tape.
+  void begin (const PushDownAutomaton& automaton, const vector<string>& tape, const vector<symbol_t>& tapeIds);
+  void record (trace_event_t event, unsigned a, unsigned b, unsigned c) {
+    trace_record_t& r = buffer_[next_];
+    r.event = event;
+    r.a = a;
+    r.b = b;
+    r.c = c;
+    recorded_++;
+    if (++next_ == buffer_.size())
+      wrap();
+  };
+  void flush ();
+
+  bool isOpen () const { return fileName_ == "" || file_.is_open(); };
+  bool isInMemory () const { return fileName_ == ""; };
+  const string& getFileName () const { return fileName_; };
+  const string& getPrologue () const { return prologue_; };
+  vector<trace_record_t> getRecords () const;   // Records kept in memory, oldest first.
+  unsigned long long getRecorded () const { return recorded_; };
+  unsigned long long getDropped () const;
+
+private:
+  void wrap ();
+  void putUnsigned (unsigned value);
+  void putString (const string& value);
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "TransitionTable.hpp"
+
+
+TransitionTable::TransitionTable () {
+  clear();
+}
+
+TransitionTable::~TransitionTable () {}
+
+// Every cell gets a slot, then the cells are laid out in the order of the slots and the transitions are
+// added to them in source order. Half of the slots at least are left empty, so the probing sequences
+// stay short and always end.
+void TransitionTable::build (const vector<transition_t>& transitions) {
+  unsigned size = 1;
+  while (size < 2 * transitions.size())
+    size *= 2;
+  cell_slot_t empty;
+  empty.state = NO_SYMBOL;
+  empty.input = empty.top = empty.begin = empty.end = 0;
+  slots_.assign(size, empty);
+
+  vector<unsigned> slotOf (transitions.size());
+  for (unsigned i = 0; i < transitions.size(); i++) {
+    const transition_t& transition = transitions[i];
+    unsigned slot = hash(transition.state, transition.input, transition.top) & (size - 1);
+    while (slots_[slot].state != NO_SYMBOL &&
+           (slots_[slot].state != transition.state || slots_[slot].input != transition.input || slots_[slot].top != transition.top))
+      slot = (slot + 1) & (size - 1);
+    slots_[slot].state = transition.state;
+    slots_[slot].input = transition.input;
+    slots_[slot].top = transition.top;
+    slots_[slot].end++;
+    slotOf[i] = slot;
+  }
+
+  unsigned begin = 0;
+  for (unsigned slot = 0; slot < size; slot++) {
+    slots_[slot].begin = begin;
+    begin += slots_[slot].end;
+    slots_[slot].end = slots_[slot].begin;
+  }
+  entries_.assign(transitions.size(), 0);
+  for (unsigned i = 0; i < transitions.size(); i++)
+    entries_[slots_[slotOf[i]].end++] = i;
+
+  slotsData_ = slots_.data();
+  entriesData_ = entries_.data();
+  slotCount_ = slots_.size();
+  entryCount_ = entries_.size();
+}
+
+void TransitionTable::attach (const cell_slot_t* slots, unsigned slotCount, const unsigned* entries, unsigned entryCount) {
+  slots_.clear();
+  entries_.clear();
+  slotsData_ = slots;
+  slotCount_ = slotCount;
+  entriesData_ = entries;
+  entryCount_ = entryCount;
+}
+
+void TransitionTable::clear () {
+  build(vector<transition_t>());
+}
+
@@ -0,0 +1,75 @@
+/***
+* @description: Transition table of the pushdown automaton indexed by (state, input symbol, stack top).
+*               Every cell keeps the indexes of its transitions in the same order they were read. Only
+*               the cells with transitions are kept, in a hash table, so the table grows with the number of
+*               transitions and not with the number of states and symbols.
+***/
+#ifndef _TRANSITION_TABLE_HPP_
+#define _TRANSITION_TABLE_HPP_
+#include <string>
+#include <vector>
+#include "SymbolTable.hpp"
+
+using namespace std;
+
+const symbol_t EPSILON = 0;   // Input symbol id reserved for "e" (transitions that don't consume input).
+
+// A transition keeps its original text to display it and its interned key to index it.
+struct transition_t {
+  string actual;   // "state input top" as written in the automaton file.
+  string next;     // "nextState symbolsToPush" as written in the automaton file.
+  symbol_t state;
+  symbol_t input;
+  symbol_t top;
+};
+
+// Slot of the hash table, made of unsigned only so an image can keep the slots as they are. An empty
+// slot has NO_SYMBOL as its state and an empty range, which is the one of the cells without transitions.
+struct cell_slot_t {
+  symbol_t state;
+  symbol_t input;
+  symbol_t top;
+  unsigned begin;   // Range of the cell in the entries.
+  unsigned end;
+};
+
+class TransitionTable {
+  vector<cell_slot_t> slots_;   // Open addressing with linear probing, the size is a power of two.
+  vector<unsigned> entries_;    // Transition indexes grouped by cell.
+  const cell_slot_t* slotsData_;   // slots_ and entries_, or the arrays of a mapped image.
+  const unsigned* entriesData_;
+  unsigned slotCount_;
+  unsigned entryCount_;
+
+public:
+  TransitionTable ();
+  ~TransitionTable ();
+
+  void build (const vector<transition_t>& transitions);
+  // Use arrays laid out like the built ones (owned by someone else, e.g. a mapped image) without copying them.
+  void attach (const cell_slot_t* slots, unsigned slotCount, const unsigned* entries, unsigned entryCount);
+  void clear ();
+
+  unsigned getSlotCount () const { return slotCount_; };
+  unsigned getEntryCount () const { return entryCount_; };
+  const cell_slot_t* getSlots () const { return slotsData_; };
+  const unsigned* getEntries () const { return entriesData_; };
+
+  // Range of transitions for the cell, empty when the cell has none. It is on the path of every move of
+  // the search, so it is inlined and the probing starts from a cheap hash.
+  void getRange (symbol_t state, symbol_t input, symbol_t top, const unsigned*& begin, const unsigned*& end) const {
+    unsigned slot = hash(state, input, top) & (slotCount_ - 1);
+    while (slotsData_[slot].state != NO_SYMBOL &&
+           (slotsData_[slot].state != state || slotsData_[slot].input != input || slotsData_[slot].top != top))
+      slot = (slot + 1) & (slotCount_ - 1);
+    begin = entriesData_ + slotsData_[slot].begin;
+    end = entriesData_ + slotsData_[slot].end;
+  };
+
+  // The ids go in one word and a multiplication mixes it, the high half is the one that depends on all of them.
+  static unsigned hash (symbol_t state, symbol_t input, symbol_t top) {
+    return ((unsigned long long) state << 42 ^ (unsigned long long) input << 21 ^ top) * 0x9E3779B97F4A7C15ULL >> 32;
+  };
+};
+
+#endif
@@ -0,0 +1,231 @@
+/***
+* @description: Benchmark of the engines of checkInput. For every family of automata, size and expected
+*               verdict an input is generated and checked by every engine in a child process, so the peak
+*               memory of one check doesn't hide the next one. The results are written as JSON.
+*               Build it with "make bench" and run bench/PdaBench [options] [--max-size N] [--levels N]
+*               [--seed N] [--output FILE]; the options are the ones of the automaton (budgets).
+***/
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <thread>
+#include "PushDownAutomaton.hpp"
+#include "Generators.hpp"
+
+using namespace std;
+
+enum bench_engine_t { DEPTH_FIRST_ENGINE, BREADTH_FIRST_ENGINE, ITERATIVE_DEEPENING_ENGINE, BEST_FIRST_ENGINE,
+                      PARALLEL_ENGINE, EARLEY_BENCH_ENGINE, DETERMINISTIC_ENGINE };
+const unsigned BENCH_ENGINE_COUNT = 7;
+const char* ENGINE_NAMES[] = { "depth_first", "breadth_first", "iterative_deepening", "best_first", "parallel", "earley",
+                               "deterministic" };
+// Search order of the engines that are a Search, in the same order.
+const search_t ENGINE_SEARCHES[] = { DEPTH_FIRST, BREADTH_FIRST, ITERATIVE_DEEPENING, BEST_FIRST };
+
+// What the child process sends back.
+struct bench_result_t {
+  check_result_t result;
+  double seconds;              // Of the check alone.
+  unsigned long explored;      // Configurations, items or moves of the engine.
+  long peakKb;                 // Peak resident memory of the check, over the one of the process before it.
+};
+
+static long getPeakKb () {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static bench_result_t check (const PushDownAutomaton& automaton, bench_engine_t engine, const vector<symbol_t>& tape,
+                             const RunConfig& config) {
+  bench_result_t res;
+  long before = getPeakKb();
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  switch (engine) {
+    case DEPTH_FIRST_ENGINE:
+    case BREADTH_FIRST_ENGINE:
+    case ITERATIVE_DEEPENING_ENGINE:
+    case BEST_FIRST_ENGINE: {
+      Search search (automaton, tape, ENGINE_SEARCHES[engine], config);
+      search.setVerbose(false);
+      search.run();
+      res.result = search.getResult();
+      res.explored = search.getExplored();
+      break;
+    }
+    case PARALLEL_ENGINE: {
+      ParallelSearch search (automaton, config);
+      search.run(automaton.getInitialState(), automaton.getInitialStack(), tape);
+      res.result = search.getResult();
+      res.explored = search.getConfigurations();
+      break;
+    }
+    case EARLEY_BENCH_ENGINE: {
+      Grammar grammar (automaton);
+      EarleyRecognizer recognizer (grammar, config);
+      recognizer.recognize(tape);
+      res.result = recognizer.getResult();
+      res.explored = recognizer.getItemCount();
+      break;
+    }
+    case DETERMINISTIC_ENGINE: {
+      DeterministicRunner runner (automaton, config);
+      runner.run(tape);
+      res.result = runner.getResult();
+      res.explored = runner.getMoves();
+      break;
+    }
+  }
+  res.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  res.peakKb = getPeakKb() - before;
+  return res;
+}
+
+// The check runs in a child process. False if it died (it ran out of memory the engine couldn't catch).
+static bool measure (const PushDownAutomaton& automaton, bench_engine_t engine, const vector<symbol_t>& tape,
+                     const RunConfig& config, bench_result_t& res) {
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+  pid_t child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    try {
+      res = check(automaton, engine, tape, config);
+    }
+    catch (exception& e) {
+      res.result = makeResult(false, MEMORY_BUDGET, false);
+      res.seconds = 0;
+      res.explored = 0;
+      res.peakKb = 0;
+    }
+    ssize_t written = write(fds[1], &res, sizeof(res));
+    _exit(written == sizeof(res) ? 0 : 1);
+  }
+  close(fds[1]);
+  bool ok = child > 0 && read(fds[0], &res, sizeof(res)) == sizeof(res);
+  close(fds[0]);
+  int status;
+  if (child > 0)
+    waitpid(child, &status, 0);
+  return ok;
+}
+
+static string getVerdictName (const check_result_t& result) {
+  if (result.verdict == INPUT_ACCEPTED)
+    return "accepted";
+  if (result.verdict == INPUT_REJECTED)
+    return "rejected";
+  return "exhausted " + RunConfig::getBudgetName(result.budget);
+}
+
+// The automaton is loaded from a temporary file like any automaton file.
+static PushDownAutomaton* loadFamily (family_t family, unsigned levels) {
+  char fileName[] = "/tmp/pdabenchXXXXXX";
+  int fd = mkstemp(fileName);
+  if (fd < 0)
+    return NULL;
+  close(fd);
+  ofstream file (fileName);
+  file << generateAutomaton(family, levels);
+  file.close();
+  PushDownAutomaton* automaton = new PushDownAutomaton (fileName);
+  unlink(fileName);
+  return automaton;
+}
+
+int main (int argc, char* argv[]) {
+  // Every check gets a deadline and a memory budget unless they are given.
+  vector<string> defaults = { "--deadline-ms", "2000", "--max-memory", "512M" };
+  vector<string> args (argv + 1, argv + argc);
+  RunConfig config;
+  if (!config.readArguments(defaults) || !config.readEnvironment() || !config.readArguments(args)) {
+    cerr << RunConfig::getUsage();
+    return EXIT_FAILURE;
+  }
+
+  unsigned long maxSize = 1000000;
+  unsigned levels = 2;
+  unsigned seed = 1;
+  string outputFileName;
+  for (unsigned i = 0; i + 1 < args.size(); i += 2) {
+    if (args[i] == "--max-size")
+      maxSize = stoul(args[i + 1]);
+    else if (args[i] == "--levels")
+      levels = stoul(args[i + 1]);
+    else if (args[i] == "--seed")
+      seed = stoul(args[i + 1]);
+    else if (args[i] == "--output")
+      outputFileName = args[i + 1];
+    else {
+      cerr << "Unknown option " << args[i] << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  ofstream outputFile;
+  if (outputFileName != "")
+    outputFile.open(outputFileName.c_str());
+  ostream& out = outputFileName != "" ? outputFile : cout;
+  mt19937 random (seed);
+
+  out << "{\"levels\": " << levels << ", \"seed\": " << seed << ", \"max_depth\": " << (config.hasStackMaxDepth() ? config.getStackMaxDepth() : 0)
+      << ", \"max_configurations\": " << config.getMaxConfigurations() << ", \"max_memory\": " << config.getMaxMemory()
+      << ", \"deadline_ms\": " << config.getDeadline() << ", \"results\": [";
+  bool first = true;
+  for (unsigned f = 0; f < FAMILY_COUNT; f++) {
+    family_t family = (family_t) f;
+    PushDownAutomaton* automaton = loadFamily(family, levels);
+    if (automaton == NULL) {
+      cerr << "The automaton of the " << getFamilyName(family) << " family can't be written" << endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned long size = 10; size <= maxSize; size *= 10)
+      for (bool accepted : { true, false }) {
+        string input = generateInput(family, levels, size, accepted, random);
+        vector<symbol_t> tape (input.size());
+        for (unsigned long i = 0; i < input.size(); i++)
+          tape[i] = automaton->getInputSymbols().find(string(1, input[i]));
+
+        // Without a depth limit, a stack can be as deep as the input.
+        RunConfig sized = config;
+        if (!sized.hasStackMaxDepth()) {
+          vector<string> depth = { "--max-depth", to_string(input.size() + 1) };
+          sized.readArguments(depth);
+        }
+
+        for (unsigned e = 0; e < BENCH_ENGINE_COUNT; e++) {
+          bench_engine_t engine = (bench_engine_t) e;
+          if (engine == DETERMINISTIC_ENGINE && !automaton->isDeterministic())
+            continue;
+          RunConfig engineConfig = sized;
+          if (engine == PARALLEL_ENGINE)
+            engineConfig.setThreads(max(2u, thread::hardware_concurrency()));
+
+          bench_result_t res;
+          bool ok = measure(*automaton, engine, tape, engineConfig, res);
+          out << (first ? "\n  " : ",\n  ") << "{\"family\": \"" << getFamilyName(family) << "\", \"engine\": \""
+              << ENGINE_NAMES[engine] << "\", \"size\": " << tape.size() << ", \"expected\": \""
+              << (accepted ? "accepted" : "rejected") << "\", ";
+          if (ok)
+            out << "\"verdict\": \"" << getVerdictName(res.result) << "\", \"seconds\": " << res.seconds
+                << ", \"explored\": " << res.explored << ", \"peak_kb\": " << res.peakKb << "}";
+          else
+            out << "\"verdict\": \"crashed\"}";
+          out.flush();
+          first = false;
+          cerr << getFamilyName(family) << " " << ENGINE_NAMES[engine] << " " << tape.size() << " "
+               << (accepted ? "accepted" : "rejected") << ": " << (ok ? getVerdictName(res.result) : "crashed") << endl;
+        }
+      }
+    delete automaton;
+  }
+  out << "\n]}" << endl;
+  return 0;
+}
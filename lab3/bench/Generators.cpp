@@ -0,0 +1,143 @@
+#include "Generators.hpp"
+#include <algorithm>
+
+static const string NONTERMINALS = "ETUVW";   // One per operator level, F is the primary.
+static const string OPERATORS = "+*-/%";
+
+string getFamilyName (family_t family) {
+  switch (family) {
+    case EXPRESSION_FAMILY: return "expression";
+    case PARENTHESES_FAMILY: return "parentheses";
+    case PALINDROME_FAMILY: return "palindrome";
+    default: return "ambiguous";
+  }
+}
+
+// The six lines of the definition and the transitions, the final state is also the only state when
+// the automaton works by empty stack.
+string generateAutomaton (family_t family, unsigned levels) {
+  levels = max(1u, min(levels, MAX_LEVELS));
+  string res;
+  switch (family) {
+    case EXPRESSION_FAMILY: {
+      string terminals = "a";
+      for (unsigned i = 0; i < levels; i++)
+        terminals += string(" ") + OPERATORS[i];
+      terminals += " ( )";
+      string nonterminals;
+      for (unsigned i = 0; i < levels; i++)
+        nonterminals += string(" ") + NONTERMINALS[i];
+      res = "q0\n" + terminals + "\nS " + terminals + nonterminals + " F\nq0\nS\nq0\n";
+      res += string("q0 e S q0 ") + NONTERMINALS[0] + "\n";
+      for (unsigned i = 0; i < levels; i++) {
+        char next = i + 1 < levels ? NONTERMINALS[i + 1] : 'F';
+        res += string("q0 e ") + NONTERMINALS[i] + " q0 " + NONTERMINALS[i] + OPERATORS[i] + next + "\n";
+        res += string("q0 e ") + NONTERMINALS[i] + " q0 " + next + "\n";
+      }
+      res += string("q0 e F q0 (") + NONTERMINALS[0] + ")\nq0 e F q0 a\n";
+      for (unsigned i = 0; i < terminals.size(); i += 2)
+        res += string("q0 ") + terminals[i] + " " + terminals[i] + " q0 e\n";
+      break;
+    }
+    case PARENTHESES_FAMILY:
+      // X is the outer parenthesis, A the ones inside.
+      res = "q0\n( )\nZ X A\nq0\nZ\nq0\n"
+            "q0 ( Z q0 X\nq0 ( X q0 AX\nq0 ( A q0 AA\nq0 ) A q0 e\nq0 ) X q0 e\n";
+      break;
+    case PALINDROME_FAMILY:
+      // x and y are the first a and b, popping them ends the input.
+      res = "q0 q1\na b\nZ a b x y\nq0\nZ\nq1\nq0 a Z q0 x\nq0 b Z q0 y\n";
+      for (string top : { "a", "b", "x", "y" })
+        res += "q0 a " + top + " q0 a" + top + "\nq0 b " + top + " q0 b" + top + "\n";
+      res += "q0 a a q1 e\nq0 b b q1 e\nq0 a x q1 e\nq0 b y q1 e\n"
+             "q1 a a q1 e\nq1 b b q1 e\nq1 a x q1 e\nq1 b y q1 e\n";
+      break;
+    case AMBIGUOUS_FAMILY:
+      res = "q0\na b\nS a\nq0\nS\nq0\nq0 e S q0 SS\nq0 e S q0 a\nq0 a a q0 e\n";
+      break;
+  }
+  return res;
+}
+
+// Operands and operators with random groups, closed as the input ends.
+static string generateExpression (unsigned levels, unsigned long size, mt19937& random) {
+  string res;
+  unsigned long open = 0;
+  while (true) {
+    while (random() % 4 == 0 && res.size() + open + 4 < size) {
+      res += '(';
+      open++;
+    }
+    res += 'a';
+    while (open > 0 && random() % 3 == 0) {
+      res += ')';
+      open--;
+    }
+    if (res.size() + open + 2 > size)
+      break;
+    res += OPERATORS[random() % levels];
+  }
+  return res + string(open, ')');
+}
+
+// Random walk that starts and ends at depth 0 without going below it.
+static string generateParentheses (unsigned long size, mt19937& random) {
+  unsigned long inner = size > 2 ? (size - 2) & ~1ul : 0;
+  unsigned long opens = inner / 2;
+  unsigned long depth = 0;
+  string res = "(";
+  for (unsigned long i = 0; i < inner; i++) {
+    if (opens > 0 && (depth == 0 || random() % 2 == 0)) {
+      res += '(';
+      opens--;
+      depth++;
+    }
+    else {
+      res += ')';
+      depth--;
+    }
+  }
+  return res + ")";
+}
+
+string generateInput (family_t family, unsigned levels, unsigned long size, bool accepted, mt19937& random) {
+  levels = max(1u, min(levels, MAX_LEVELS));
+  size = max(size, 2ul);
+  string res;
+  switch (family) {
+    case EXPRESSION_FAMILY: {
+      res = generateExpression(levels, size, random);
+      if (accepted)
+        break;
+      // A repeated operator, or a missing operand when there is no operator.
+      size_t op = res.find_first_of(OPERATORS, random() % res.size());
+      if (op == string::npos)
+        op = res.find_first_of(OPERATORS);
+      if (op == string::npos)
+        res += OPERATORS[0];
+      else
+        res.insert(op, 1, res[op]);
+      break;
+    }
+    case PARENTHESES_FAMILY:
+      res = generateParentheses(size, random);
+      if (!accepted)
+        res[res.size() - 1] = '(';
+      break;
+    case PALINDROME_FAMILY: {
+      string half;
+      for (unsigned long i = 0; i < size / 2; i++)
+        half += random() % 2 ? 'a' : 'b';
+      res = half + string(half.rbegin(), half.rend());
+      if (!accepted)
+        res[0] = res[0] == 'a' ? 'b' : 'a';
+      break;
+    }
+    case AMBIGUOUS_FAMILY:
+      res = string(size, 'a');
+      if (!accepted)
+        res[size - 1] = 'b';
+      break;
+  }
+  return res;
+}
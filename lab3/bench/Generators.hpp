@@ -0,0 +1,27 @@
+/***
+* @description: Families of pushdown automata for the benchmark, written in the format of the automaton
+*               files, and inputs of a given size that the automaton of the family accepts or rejects.
+*               Every symbol of an input is one character, like the keyboard input.
+***/
+#ifndef _GENERATORS_HPP_
+#define _GENERATORS_HPP_
+#include <string>
+#include <random>
+
+using namespace std;
+
+enum family_t {
+  EXPRESSION_FAMILY,    // Arithmetic expressions like t.data, with one nonterminal per operator level.
+  PARENTHESES_FAMILY,   // One group of balanced parentheses, deterministic.
+  PALINDROME_FAMILY,    // Even palindromes over a and b, the middle is guessed.
+  AMBIGUOUS_FAMILY      // S -> SS | a, with a Catalan number of derivations for every input.
+};
+const unsigned FAMILY_COUNT = 4;
+const unsigned MAX_LEVELS = 5;   // Operator levels of the expression family.
+
+string getFamilyName (family_t family);
+string generateAutomaton (family_t family, unsigned levels);
+// An input of about size symbols. The rejected ones differ from an accepted one in a single place.
+string generateInput (family_t family, unsigned levels, unsigned long size, bool accepted, mt19937& random);
+
+#endif
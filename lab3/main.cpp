@@ -2,8 +2,10 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <thread>
+#include "BatchChecker.hpp"
 
-#define EXIT 7
+#define EXIT 9
 
 using namespace std;
 
@@ -17,19 +19,115 @@ int showMenu () {
 	cout << "4. Load input from keyboard." << endl;
 	cout << "5. Accepted input?" << endl;
 	cout << "6. Accepted input? (with trace)" << endl;
-	cout << "7. Exit" << endl << endl;
+	cout << "7. Change search order (depth-first / breadth-first / iterative deepening / best-first)." << endl;
+	cout << "8. Change engine (search / Earley parser)." << endl;
+	cout << "9. Exit" << endl << endl;
 
-	cout << "Insert option (1-7): ";
+	cout << "Insert option (1-9): ";
 	cin >> option;
 
   return option;
 }
 
 void executeAutomaton (PushDownAutomaton* automaton, bool trace) {
-	if (automaton->checkInput(trace))
+	check_result_t result = automaton->checkInput(trace);
+	if (result.verdict == INPUT_ACCEPTED)
 		cout << endl << "Input is accepted" << endl << endl;
 	else
 		cout << endl << "Input is NOT accepted" << endl << endl;
+	if (result.verdict == BUDGET_EXHAUSTED)
+		cout << "Budget exhausted: " << automaton->getRunConfig().describe(result.budget) << endl;
+	automaton->showSearchUsage();
+	if (automaton->getRunConfig().hasStatistics())
+		automaton->showStatistics();
+}
+
+void changeSearch (PushDownAutomaton* automaton) {
+	search_t search = (search_t) ((automaton->getSearch() + 1) % SEARCH_COUNT);
+	automaton->setSearch(search);
+	cout << "Search order: " << RunConfig::getSearchName(search) << endl;
+}
+
+void changeEngine (PushDownAutomaton* automaton) {
+	if (automaton->getEngine() == SEARCH_ENGINE) {
+		automaton->setEngine(EARLEY_ENGINE);
+		cout << "Engine: Earley parser" << endl;
+	}
+	else {
+		automaton->setEngine(SEARCH_ENGINE);
+		cout << "Engine: search" << endl;
+	}
+}
+
+// Non-interactive mode: check every line of the words file and write one verdict per line,
+// the summary goes to the error output so the verdicts can be piped.
+int batchMode (string automatonFileName, string wordsFileName, unsigned threads, const RunConfig& config) {
+	PushDownAutomaton automaton (automatonFileName);
+	if (!automaton.isLoaded())
+		return EXIT_FAILURE;
+	automaton.setRunConfig(config);
+	BatchChecker checker (automaton, threads);
+	if (!checker.loadWords(wordsFileName))
+		return EXIT_FAILURE;
+	checker.run();
+	checker.showVerdicts(cout);
+	checker.showSummary(cerr);
+	return 0;
+}
+
+// Check an input read from a file or the standard input ("-") while it arrives, for inputs that don't
+// fit in memory. The verdict is followed by what the check kept.
+int streamMode (string automatonFileName, string inputFileName, const RunConfig& config) {
+	PushDownAutomaton automaton (automatonFileName);
+	if (!automaton.isLoaded())
+		return EXIT_FAILURE;
+	automaton.setRunConfig(config);
+	if (!automaton.canStream()) {
+		cerr << "The automaton has e-transitions that grow the stack without reading, it can only be checked in "
+		     << "stream mode with a stack depth limit (--max-depth or STACK_MAX_DEPTH)" << endl;
+		return EXIT_FAILURE;
+	}
+	TapeStream tape (automaton.getInputSymbols());
+	if (!tape.open(inputFileName)) {
+		cerr << "The input can't be read: " << inputFileName << endl;
+		return EXIT_FAILURE;
+	}
+	check_result_t result = automaton.checkStream(tape);
+	if (result.verdict == INPUT_ACCEPTED)
+		cout << "accepted" << endl;
+	else if (result.verdict == INPUT_REJECTED)
+		cout << "rejected" << endl;
+	else
+		cout << "exhausted " << RunConfig::getBudgetName(result.budget) << endl;
+	automaton.showSearchUsage();
+	return 0;
+}
+
+// Write the compiled image of an automaton, it can be loaded like the automaton file.
+int compileMode (string automatonFileName, string imageFileName) {
+	PushDownAutomaton automaton (automatonFileName);
+	if (!automaton.isLoaded())
+		return EXIT_FAILURE;
+	if (!automaton.compile(imageFileName)) {
+		cerr << "The image can't be written: " << imageFileName << endl;
+		return EXIT_FAILURE;
+	}
+	cout << "Compiled " << automaton.getTransitions().size() << " transitions into " << imageFileName << endl;
+	return 0;
+}
+
+// Render a trace file written by a search (TRACE_FILE) as the trace table or as JSON.
+int formatTraceMode (string traceFileName, string format) {
+	TraceFormatter formatter;
+	if (!formatter.load(traceFileName)) {
+		cerr << "The trace file can't be read: " << traceFileName << endl;
+		return EXIT_FAILURE;
+	}
+	if (format == "json")
+		formatter.showJson(cout);
+	else
+		formatter.showTable(cout);
+	return 0;
 }
 
 int main (int argc, char * argv[]) {
@@ -37,11 +135,52 @@ int main (int argc, char * argv[]) {
 	string inputFileName;
 	int option;
 
-	if (getenv("STACK_MAX_DEPTH") == NULL) {
-		cout << "env varible 'STACK_MAX_DEPTH' is not set" << endl;
+	// Limits of the checks, the options of the command line override the environment.
+	vector<string> args (argv + 1, argv + argc);
+	RunConfig config;
+	if (!config.readEnvironment() || !config.readArguments(args)) {
+		cerr << RunConfig::getUsage();
 		return EXIT_FAILURE;
 	}
 
+	if (args.size() > 0 && args[0] == "--compile") {
+		if (args.size() < 3) {
+			cerr << "Usage: " << argv[0] << " --compile automaton_file image_file" << endl;
+			return EXIT_FAILURE;
+		}
+		return compileMode (args[1], args[2]);
+	}
+
+	if (args.size() > 0 && args[0] == "--format-trace") {
+		if (args.size() < 2) {
+			cerr << "Usage: " << argv[0] << " --format-trace trace_file [table|json]" << endl;
+			return EXIT_FAILURE;
+		}
+		return formatTraceMode (args[1], args.size() > 2 ? args[2] : "table");
+	}
+
+	if (args.size() > 0 && args[0] == "--batch") {
+		if (args.size() < 3) {
+			cerr << "Usage: " << argv[0] << " [options] --batch automaton_file words_file [threads]" << endl;
+			return EXIT_FAILURE;
+		}
+		unsigned batchThreads = max(thread::hardware_concurrency(), 1u);
+		if (args.size() > 3 && !RunConfig::readThreads(args[3], batchThreads)) {
+			cerr << "Wrong number of threads: " << args[3] << " (from 1 to " << MAX_THREADS << ")" << endl;
+			cerr << "Usage: " << argv[0] << " [options] --batch automaton_file words_file [threads]" << endl;
+			return EXIT_FAILURE;
+		}
+		return batchMode (args[1], args[2], batchThreads, config);
+	}
+
+	if (args.size() > 0 && args[0] == "--stream") {
+		if (args.size() < 2) {
+			cerr << "Usage: " << argv[0] << " [options] --stream automaton_file [input_file|-]" << endl;
+			return EXIT_FAILURE;
+		}
+		return streamMode (args[1], args.size() > 2 ? args[2] : "-", config);
+	}
+
 	PushDownAutomaton * automaton;
 	do {
 		option = showMenu();
@@ -51,6 +190,7 @@ int main (int argc, char * argv[]) {
 			  cout << "Insert the automaton filename: ";
 				cin >> automatonFileName;
 				automaton = new PushDownAutomaton (automatonFileName);
+				automaton->setRunConfig(config);
 				break;
 			case 2:
 				automaton->show();
@@ -70,6 +210,12 @@ int main (int argc, char * argv[]) {
 				executeAutomaton (automaton, true);
 				break;
 			case 7:
+				changeSearch (automaton);
+				break;
+			case 8:
+				changeEngine (automaton);
+				break;
+			case 9:
 				cout << "Exiting..." << endl;
 				break;
 			default: